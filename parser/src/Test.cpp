@@ -1,6 +1,10 @@
-﻿#include <iostream>
+﻿#include <chrono>
+#include <iostream>
 #include <fstream>
+#include <thread>
 #include "parser/Parser.h"
+#include "parser/Batch.h"
+#include "parser/Push.h"
 using namespace em;
 using namespace em::parser;
 struct Grammar : GrammarBase<int64_t>
@@ -102,11 +106,576 @@ public:
 		start = Skipper >> Expr;
 	}
 };
+// A grammar around one rule, for the checks below.
+template <typename Out>
+struct Sample : GrammarBase<Out>
+{
+	using GrammarBase<Out>::StoreSpanId;
+	Rule<Out> start;
+	Sample() : GrammarBase<Out>(start) {}
+};
+
+static int failures = 0;
+static void Check(bool ok, char const* what)
+{
+	if (ok) return;
+	std::cout << "[Fail]" << what << std::endl;
+	failures++;
+}
+static int64_t SpanToInt(Span const& s)
+{
+	return std::stoll(s.Str());
+}
+// The value when 'code' matches to its end, or null.
+template <typename Out>
+static Nullable<WarpVoid<Out>> ParseAll(GrammarBase<Out>& g, String& code)
+{
+	U32Itor begin(code.begin()), end(code.end());
+	auto ret = Parse(begin, end, g);
+	if (begin != end) return null;
+	return ret;
+}
+// Expressions for the demo grammar, every eighth one broken. There is
+// no division, as an operand may come to 0.
+static Vector<String> Samples(size_t count)
+{
+	using namespace std;
+	static char const* ops[] = { " + ", "-", " * ", u8" プラス ", " /* c */ + ", "\n* ", "+" };
+	static char const* nums[] = { "7", "12_3", "0x1F", "0b101", "4`0", "(3 - 1)" };
+	Vector<String> ret;
+	uint32_t seed = 1;
+	auto next = [&seed](uint32_t n) { seed = seed * 1103515245 + 12345; return (seed >> 16) % n; };
+	for (size_t i = 0; i < count; i++)
+	{
+		String code = nums[next(6)];
+		for (uint32_t j = next(6); j; j--)
+		{
+			String operand = nums[next(6)];
+			if (!next(4)) operand = "(" + operand + ops[next(7)] + nums[next(6)] + ")";
+			code += ops[next(7)] + operand;
+		}
+		// A byte of an ASCII character, the input stays valid UTF-8.
+		size_t at = next((uint32_t)code.size());
+		if (7 == i % 8 && (uint8_t)code[at] < 0x80) code.erase(at, 1);
+		ret.push_back(code);
+	}
+	return ret;
+}
+
+// Optimize() keeps what the demo grammar matches and yields.
+static void CheckOptimize()
+{
+	Grammar plain, optimized;
+	optimized.Optimize();
+	for (auto& code : Samples(2000))
+	{
+		U32Itor b1(code.begin()), b2(code.begin()), end(code.end());
+		auto r1 = Parse(b1, end, plain);
+		auto r2 = Parse(b2, end, optimized);
+		bool same = r1.IsNull() == r2.IsNull() && b1 == b2 && (r1.IsNull() || r1.Get() == r2.Get());
+		Check(same, "Optimize changes a result");
+		if (!same) std::cout << "  " << code << std::endl;
+	}
+
+	// An option that fails halfway is left where it failed, "1." here.
+	Sample<Void> number[2];
+	Sample<Span> token[2];
+	for (int i = 0; i < 2; i++)
+	{
+		number[i].start = NoSkip >> (+char_("0-9") > -("." > +char_("0-9")));
+		token[i].start = capture_(+char_("0-9") > -("." > +char_("0-9")));
+	}
+	number[1].Optimize();
+	token[1].Optimize();
+	String code = "1.x";
+	size_t moved[2], length[2];
+	for (int i = 0; i < 2; i++)
+	{
+		U32Itor begin(code.begin()), end(code.end());
+		Parse(begin, end, number[i]);
+		moved[i] = begin.Base() - code.begin();
+		U32Itor from(code.begin());
+		auto span = Parse(from, end, token[i]);
+		length[i] = span.IsNull() ? 0 : span.Get().Size();
+	}
+	Check(2 == moved[0] && moved[0] == moved[1], "Optimize keeps where a sequence failed halfway");
+	Check(2 == length[0] && length[0] == length[1], "Optimize keeps where a sequence failed halfway in capture_");
+
+	// Joined literals report the piece that did not match.
+	Sample<Void> words;
+	words.start = NoSkip >> (tk_("begin") > tk_(" ") > tk_("end"));
+	words.Optimize();
+	code = "begin ent";
+	U32Itor begin(code.begin()), end(code.end());
+	auto report = ParseWithReport(begin, end, words);
+	Check(report.value.IsNull() && 7 == report.farthest.loc.col
+		&& String("Line 1, Col 7: expected \"end\".") == report.farthest.Error().what(),
+		"Optimize keeps where a joined literal failed");
+
+	// Fused literal alternatives are compiled, unless a shorter key goes first.
+	auto fused = tk_("ab") | tk_("a");
+	Dfa dfa;
+	Check(dfa.Add(fused.expr.get(), 0) && dfa.Build(), "Dfa takes fused literal alternatives");
+	Sample<Span> keys[2];
+	keys[0].start = capture_(+(tk_("ab") | tk_("a")));
+	keys[1].start = capture_(+(tk_("a") | tk_("ab")));
+	code = "abab";
+	size_t sizes[2] = { 4, 1 };
+	for (int i = 0; i < 2; i++)
+	{
+		keys[i].Optimize();
+		U32Itor begin(code.begin()), end(code.end());
+		auto span = Parse(begin, end, keys[i]);
+		Check(!span.IsNull() && sizes[i] == span.Get().Size(), "Optimize keeps the key order of fused literal alternatives");
+	}
+}
+
+static void CheckRecover()
+{
+	auto num = capture_(+char_("0-9")) ^ SpanToInt;
+	Sample<Vector<int64_t>> g;
+	g.start = *recover_(num > ";", ";");
+	String code = "12;x;345;";
+	auto values = ParseAll(g, code);
+	Check(!values.IsNull() && 3 == values.Get().size() && 1 == g.Context().errors.size(),
+		"recover_ skips one error in Parse");
+	U32Itor begin(code.begin()), end(code.end());
+	Check(!Validate(begin, end, g) || begin != end, "Validate rejects what recover_ skips");
+
+	// The error is given up with the alternative that recovered.
+	Sample<Void> h;
+	auto first = (recover_(num > ";", ";") > "!") ^ [](int64_t const&) {};
+	auto second = +set_("^!") ^ [](Vector<CharT> const&) {};
+	h.start = first | second;
+	code = "x;y";
+	begin = U32Itor(code.begin());
+	end = U32Itor(code.end());
+	auto report = ParseWithReport(begin, end, h);
+	Check(!report.value.IsNull() && report.errors.empty(), "recover_ errors are dropped on backtracking");
+}
+
+static void CheckPrecedence()
+{
+	auto num = capture_(+char_("0-9")) ^ SpanToInt;
+	Sample<int64_t> g;
+	g.start = char_(" ") >> precedence_(num, Operators<int64_t>()
+		.Infix("+", 10, Assoc::Left, [](int64_t const& l, int64_t const& r) { return l + r; })
+		.Infix("-", 10, Assoc::Left, [](int64_t const& l, int64_t const& r) { return l - r; })
+		.Infix("*", 20, Assoc::Left, [](int64_t const& l, int64_t const& r) { return l * r; })
+		.Infix("^", 30, Assoc::Right, [](int64_t const& l, int64_t const& r)
+		{
+			int64_t ret = 1;
+			for (int64_t i = 0; i < r; i++) ret *= l;
+			return ret;
+		})
+		.Prefix("-", 25, [](int64_t const& v) { return -v; })
+		.Postfix("!", 40, [](int64_t const& v) { return v * 2; }));
+	String code = "-2 * 3 + 4 ^ 2 ^ 1 - 1 - 1 + 3!";
+	auto value = ParseAll(g, code);
+	Check(!value.IsNull() && -6 + 16 - 2 + 6 == value.Get(), "precedence_ binds by power and associativity");
+
+	// "!" is also infix: a ! b is a - b.
+	Sample<int64_t> h;
+	h.start = precedence_(num, Operators<int64_t>()
+		.Infix("!", 10, Assoc::Left, [](int64_t const& l, int64_t const& r) { return l - r; })
+		.Postfix("!", 40, [](int64_t const& v) { return v * 2; }));
+	code = "7!3!";
+	value = ParseAll(h, code);
+	Check(!value.IsNull() && 7 - 6 == value.Get(), "precedence_ keeps an operator both infix and postfix");
+
+	// "-" without an operand after it starts the operand "-x".
+	auto ops = Operators<int64_t>().Prefix("-", 25, [](int64_t const& v) { return -v; });
+	auto minusX = num | tk_("-x") ^ []() { return int64_t(99); };
+	Sample<int64_t> k;
+	k.start = precedence_(minusX, ops);
+	code = "-x";
+	value = ParseAll(k, code);
+	Check(!value.IsNull() && 99 == value.Get(), "precedence_ tries the operand when a prefix operator has none");
+	Sample<Span> m;
+	m.start = capture_(precedence_(minusX, ops));
+	auto text = ParseAll(m, code);
+	Check(!text.IsNull() && "-x" == text.Get().Str(), "precedence_ matches the operand when a prefix operator has none");
+}
+
+static void CheckFold()
+{
+	Sample<int64_t> g;
+	g.start = "0x" > fold_(CharSet("0-9a-f"), int64_t(0), [](int64_t& sum, CharT const& c)
+	{
+		sum = sum * 16 + (c <= '9' ? c - '0' : c - 'a' + 10);
+	}, 1);
+	String code = "0xff";
+	auto value = ParseAll(g, code);
+	Check(!value.IsNull() && 255 == value.Get(), "fold_ steps through the digits");
+
+	Sample<size_t> h;
+	h.start = sep_fold_(char_("a-z"), tk_(","), size_t(0), [](size_t& n, Void const&) { n++; });
+	code = "a,b,c,";
+	U32Itor begin(code.begin()), end(code.end());
+	auto count = Parse(begin, end, h);
+	Check(!count.IsNull() && 3 == count.Get() && 5 == begin.Pos(), "sep_fold_ leaves a trailing separator");
+
+	size_t steps = 0;
+	Sample<Void> k;
+	k.start = NoSkip >> sep_fold_(set_("a-z"), tk_(","), Void(), [&](Void&, CharT const&) { steps++; });
+	k.Optimize();
+	code = "a,b,c";
+	Check(!ParseAll(k, code).IsNull() && 3 == steps, "Optimize keeps the steps of a fold");
+}
+
+static void CheckSymbols()
+{
+	Sample<int> g;
+	g.start = symbols_(Symbols<int>().Add("+", 1).Add("++", 2).Add(U"プラス", 3));
+	String code = "++";
+	auto value = ParseAll(g, code);
+	Check(!value.IsNull() && 2 == value.Get(), "symbols_ takes the longest key");
+	code = u8"プラス";
+	value = ParseAll(g, code);
+	Check(!value.IsNull() && 3 == value.Get(), "symbols_ matches UTF-8 keys");
+	Sample<Void> k;
+	k.start = tk_(u8"プラス") > u8"é";
+	code = u8"プラスé";
+	Check(!ParseAll(k, code).IsNull(), "tk_ takes char strings as UTF-8 like symbols_");
+
+	Sample<Void> h;
+	h.start = keywords_({ "in", "int" });
+	code = "int";
+	Check(!ParseAll(h, code).IsNull(), "keywords_ matches a keyword");
+	code = "integer";
+	U32Itor begin(code.begin()), end(code.end());
+	Check(Parse(begin, end, h).IsNull(), "keywords_ stops at an identifier character");
+}
+
+// span_, until_, ident_ and capture_ give views of the input.
+static void CheckSpans()
+{
+	Sample<Span> g;
+	g.start = "/*" > until_("*/") > "*/";
+	String code = "/* a * b */";
+	auto text = ParseAll(g, code);
+	Check(!text.IsNull() && " a * b " == text.Get().Str(), "until_ stops at the terminator");
+
+	g.start = ident_();
+	code = u8"café_1";
+	text = ParseAll(g, code);
+	Check(!text.IsNull() && code == text.Get().Str(), "ident_ takes Unicode identifiers");
+
+	g.start = span_("a-z", 2, 3) > "!";
+	code = "abcd!";
+	Check(ParseAll(g, code).IsNull(), "span_ keeps to its maximum");
+
+	g.start = capture_(char_("a-z") > *char_("a-z0-9"));
+	g.Optimize();
+	code = "ab12";
+	text = ParseAll(g, code);
+	Check(!text.IsNull() && "ab12" == text.Get().Str(), "capture_ gives the text matched");
+}
+
+static void CheckCut()
+{
+	Rule<int64_t> expr{ "expression" };
+	auto num = capture_(+char_("0-9")) ^ SpanToInt;
+	expr = num;
+	Sample<int64_t> g;
+	g.start = "(" >= expr > ")" | num;
+	String code = "(x)";
+	try
+	{
+		ParseAll(g, code);
+		Check(false, "cut_ throws a ParseError");
+	}
+	catch (ParseError const& e)
+	{
+		Check(1 == e.loc.line && 2 == e.loc.col && "expression" == e.expected, "cut_ reports where and what");
+	}
+}
+
+static void CheckLexer()
+{
+	enum Kind : uint32_t { Number, Plus };
+	Lexer lexer;
+	lexer.Add(Number, +char_("0-9"))
+		.Add(Plus, tk_("+"))
+		.Skip(+char_(" \n"));
+	Check(lexer.Build(), "Lexer builds");
+	String code = "1 + 23 + 400";
+	U32Itor begin(code.begin()), end(code.end());
+	TokenStream tokens;
+	Check(lexer.Tokenize(begin, end, tokens) && 5 == tokens.tokens.size(), "Lexer cuts tokens");
+	Sample<int64_t> g;
+	g.start = sep_fold_(token_text_(Number), token_(Plus), int64_t(0),
+		[](int64_t& sum, Span const& s) { sum += SpanToInt(s); });
+	uint32_t index = 0;
+	auto sum = Parse(tokens, index, g);
+	Check(!sum.IsNull() && 424 == sum.Get() && 5 == index, "Parse runs on tokens");
+
+	code = "1 +\n 23 + +";
+	U32Itor from(code.begin()), to(code.end());
+	Check(lexer.Tokenize(from, to, tokens), "Lexer cuts tokens over lines");
+	index = 0;
+	auto report = ParseWithReport(tokens, index, g);
+	Check(3 == index && 2 == report.farthest.loc.line && 7 == report.farthest.loc.col,
+		"Errors on tokens are located in the source");
+
+	Lexer wide;
+	wide.Add(TokenStream::MaxKind + 1, tk_("x"));
+	Check(!wide.Build(), "Lexer rejects kinds outside the private use area");
+	Lexer last;
+	last.Add(TokenStream::MaxKind, tk_("x"));
+	code = "xx";
+	U32Itor at(code.begin()), stop(code.end());
+	Sample<Void> two;
+	two.start = token_(TokenStream::MaxKind) > token_(TokenStream::MaxKind);
+	index = 0;
+	Check(last.Build() && last.Tokenize(at, stop, tokens) && !Parse(tokens, index, two).IsNull() && 2 == index,
+		"Parse runs on the highest token kind");
+}
+
+static void CheckCharSet()
+{
+	CharSet letters("a-z"), vowels("aeiou");
+	CharSet consonants = letters - vowels;
+	Check(consonants.Has('b') && !consonants.Has('a'), "CharSet difference");
+	Check((letters & CharSet("x-z0-9")).Has('y') && !(letters & CharSet("x-z0-9")).Has('1'), "CharSet intersection");
+	Check(!(~letters).Has('q') && (~letters).Has(0x10FFFF), "CharSet complement");
+	Check(XID_Start.Has(U'é') && !XID_Start.Has('1') && XID_Continue.Has('1'), "Unicode tables");
+
+	// Runs of letters cut by a space, a digit or a byte of 'é' now and then.
+	String text;
+	for (uint32_t i = 0; i < 3000; i++)
+		text += 0 == i % 41 ? ' ' : 0 == i % 67 ? '7' : 0 == i % 89 ? '\xC3' : (char)('a' + i * 7 % 26);
+	Vector<size_t> plain;
+	{
+		CharSet::Narrow none(CharSet::Simd::None);
+		for (size_t i = 0; i < text.size(); i++) plain.push_back(letters.Prefix(text.data() + i, text.size() - i));
+	}
+	for (auto level : { CharSet::Simd::Ssse3, CharSet::Simd::Avx2 })
+	{
+		if (level > CharSet::simd) break;
+		CharSet::Narrow narrow(level);
+		bool same = true;
+		for (size_t i = 0; i < text.size(); i++)
+			same = same && plain[i] == letters.Prefix(text.data() + i, text.size() - i);
+		Check(same, CharSet::Simd::Avx2 == level ? "CharSet::Prefix with AVX2" : "CharSet::Prefix with SSSE3");
+	}
+
+	// The nibbles generated with the Unicode tables.
+	bool same = true;
+	for (char c = 0; c >= 0; c++)
+		for (CharSet const* set : { &XID_Start, &XID_Continue, &Full_Width, &Control_Char })
+			same = same && (set->Has((CharT)c) ? 32 : 0) == set->Prefix(String(32, c).data(), 32);
+	Check(same, "Unicode tables test bytes in bulk");
+}
+
+static void CheckAnalyze()
+{
+	Rule<Void> unset{ "unset" }, loop{ "loop" };
+	Sample<Void> g;
+	g.start = unset > "x";
+	auto issues = g.Analyze();
+	Check(1 == issues.size() && GrammarIssue::Type::UnassignedRule == issues[0].type, "Analyze finds an unassigned rule");
+
+	Sample<Void> h;
+	loop = loop > "x" | tk_("y");
+	h.start = loop;
+	issues = h.Analyze();
+	Check(std::any_of(issues.begin(), issues.end(), [](GrammarIssue const& i)
+		{ return GrammarIssue::Type::LeftRecursion == i.type; }), "Analyze finds left recursion");
+
+	// Through a prefix operator of precedence_.
+	Rule<int64_t> value{ "value" };
+	Rule<Void> sign{ "sign" };
+	auto num = capture_(+char_("0-9")) ^ SpanToInt;
+	value = precedence_(num, Operators<int64_t>()
+		.Prefix(Node<Void>{ sign.Alias() }, 10, [](int64_t const& v) { return -v; }));
+	sign = Node<Void>{ std::make_shared<Cast<int64_t, void>>(value.Alias(), [](int64_t const&) {}) } > "-";
+	Sample<int64_t> k;
+	k.start = value;
+	issues = k.Analyze();
+	Check(std::any_of(issues.begin(), issues.end(), [](GrammarIssue const& i)
+		{ return GrammarIssue::Type::LeftRecursion == i.type; }), "Analyze looks into prefix operators");
+
+	auto hidden = [](Vector<GrammarIssue> const& issues)
+	{
+		return std::any_of(issues.begin(), issues.end(), [](GrammarIssue const& i)
+			{ return GrammarIssue::Type::OverlappingChoice == i.type; });
+	};
+	Grammar demo;
+	Check(!hidden(demo.Analyze()), "Analyze lets alternatives share a start");
+	Sample<Void> m;
+	m.start = +char_("a") | tk_("aab");
+	Check(hidden(m.Analyze()), "Analyze finds an alternative hidden by an earlier one");
+	m.start = tk_("aab") | +char_("a");
+	Check(!hidden(m.Analyze()), "Analyze lets a longer alternative go first");
+	m.start = tk_("<") | tk_("<=");
+	Check(hidden(m.Analyze()), "Analyze finds a literal hidden by an earlier one");
+	m.start = tk_("<=") | tk_("<");
+	Check(!hidden(m.Analyze()), "Analyze lets a longer literal go first");
+}
+
+// ParseBatch gives what parsing the inputs one by one gives.
+static void CheckBatch()
+{
+	Grammar g;
+	Vector<String> const inputs = Samples(500);
+	auto values = ParseBatch(g, inputs, 4);
+	bool same = values.size() == inputs.size();
+	for (size_t i = 0; same && i < inputs.size(); i++)
+	{
+		String input = inputs[i];
+		auto one = ParseAll(g, input);
+		same = one.IsNull() == values[i].IsNull() && (one.IsNull() || one.Get() == values[i].Get());
+	}
+	Check(same, "ParseBatch matches sequential parses");
+}
+
+// split_ gives the values and ids a sequential parse gives.
+static void CheckSplit()
+{
+	String code;
+	for (int i = 0; i < 5000; i++) code += "n" + std::to_string(i * 7919 % 613) + "\n";
+	Vector<Vector<uint32_t>> ids;
+	Vector<Vector<String>> names;
+	for (int mode = 0; mode < 3; mode++)
+	{
+		Sample<Vector<uint32_t>> g;
+		auto name = (ident_() ^ g.StoreSpanId) > "\n";
+		if (0 == mode) g.start = split_(name, "\n", 4, 1 << 30);
+		else if (1 == mode) g.start = split_(name, "\n", 4, 64);
+		else g.start = split_(name, "\n", SplitSyntax(), [](uint32_t& id, IdMap const& map)
+		{
+			id = map.ids[id];
+		}, 4, 64);
+		auto value = ParseAll(g, code);
+		Check(!value.IsNull(), "split_ parses every record");
+		if (value.IsNull()) return;
+		ids.push_back(value.Get());
+		names.emplace_back();
+		for (auto id : value.Get()) names.back().push_back(g.GetId(id));
+	}
+	Check(ids[0] == ids[1] && ids[0] == ids[2] && names[0] == names[1] && names[0] == names[2],
+		"split_ ids match a sequential parse");
+
+	// Cuts stay out of quotes and brackets.
+	code.clear();
+	for (int i = 0; i < 3000; i++) code += i % 3 ? "\"a,b\"," : i % 5 ? "[c,[d]]," : "e,";
+	auto item = capture_("\"" > *char_("^\"") > "\"" | "[" > *char_("^]") > "]" > -tk_("]") | char_("a-z"));
+	Vector<Vector<String>> items;
+	for (uint32_t chunk : { 1u << 30, 64u })
+	{
+		Sample<Vector<Span>> g;
+		g.start = split_(item > ",", ",", SplitSyntax{ '"', '\\', "[]" }, 4, chunk);
+		auto value = ParseAll(g, code);
+		items.emplace_back();
+		if (!value.IsNull())
+			for (auto& s : value.Get()) items.back().push_back(s.Str());
+	}
+	Check(3000 == items[0].size() && items[0] == items[1], "split_ cuts at top level only");
+}
+
+// Feeding the input in parts gives the messages feeding it whole gives.
+static void CheckPush()
+{
+	Grammar g;
+	String stream;
+	for (auto& code : Samples(40))
+		if (!ParseAll(g, code).IsNull()) stream += (stream.empty() ? "" : "\n") + code;
+	auto run = [&](size_t part, Vector<int64_t>& out)
+	{
+		PushParser<int64_t> p(g, [&](int64_t& value, ParseContext&) { out.push_back(value); });
+		for (size_t at = 0; at < stream.size(); at += part)
+			p.Feed(stream.data() + at, std::min(part, stream.size() - at));
+		return p.Finish();
+	};
+	Vector<int64_t> whole, parts;
+	Check(run(stream.size(), whole), "PushParser parses a whole stream");
+	for (size_t part : { 1, 2, 7 })
+	{
+		parts.clear();
+		Check(run(part, parts) && parts == whole, "PushParser gives the same messages from parts");
+	}
+	// Cut anywhere, skipped text included.
+	for (String code : { "1 /* a rather long comment here */ + 2", "7 // line comment text\n* 3" })
+		for (size_t at = 1; at < code.size(); at++)
+		{
+			Vector<int64_t> out;
+			PushParser<int64_t> p(g, [&](int64_t& value, ParseContext&) { out.push_back(value); });
+			bool ok = p.Feed(code.data(), at) && p.Feed(code.data() + at, code.size() - at) && p.Finish();
+			Check(ok && 1 == out.size() && (3 == out[0] || 21 == out[0]), "PushParser waits out skipped text");
+		}
+
+	// A large message fed byte by byte is parsed a few times past Eager bytes.
+	size_t parses = 0, messages = 0;
+	Sample<Void> h;
+	h.start = (tk_("") ^ [&]() { parses++; }) > *char_("a") > ";";
+	String code(20000, 'a');
+	code += ';';
+	PushParser<Void> p(h, [&](Void&, ParseContext&) { messages++; });
+	bool ok = true;
+	for (auto& c : code) ok = ok && p.Feed(&c, 1);
+	Check(ok && p.Finish() && 1 == messages && parses < PushParser<Void>::Eager + 32,
+		"PushParser parses a message fed in small parts in linear time");
+}
+
+static int RunChecks()
+{
+	CheckOptimize();
+	CheckRecover();
+	CheckPrecedence();
+	CheckFold();
+	CheckSymbols();
+	CheckSpans();
+	CheckCut();
+	CheckLexer();
+	CheckCharSet();
+	CheckAnalyze();
+	CheckBatch();
+	CheckSplit();
+	CheckPush();
+	if (failures) std::cout << failures << " checks failed." << std::endl;
+	else std::cout << "All checks passed." << std::endl;
+	return failures ? 1 : 0;
+}
+// Parses a batch of generated expressions on 1, 2, 4... threads, up to
+// one per core, and prints the throughput.
+static void BenchBatch(Grammar& g)
+{
+	using namespace std;
+	Vector<String> inputs;
+	size_t bytes = 0;
+	for (int i = 0; i < 100000; i++)
+	{
+		String code = to_string(i);
+		for (int j = 1; j < 20; j++)
+			code += (j % 3 ? " + (" : " * (") + to_string(i + j) + " - 0x1F) / 3";
+		bytes += code.size();
+		inputs.push_back(code);
+	}
+	uint32_t cores = WorkPool::Threads(0, inputs.size());
+	for (uint32_t threads = 1; ; threads = min(threads * 2, cores))
+	{
+		auto from = chrono::steady_clock::now();
+		auto values = ParseBatch(g, inputs, threads);
+		double secs = chrono::duration<double>(chrono::steady_clock::now() - from).count();
+		size_t failed = count_if(values.begin(), values.end(),
+			[](Nullable<int64_t> const& v) { return v.IsNull(); });
+		cout << threads << " threads: " << inputs.size() / secs << " docs/s, "
+			<< bytes / secs / 1e6 << " MB/s, " << failed << " failed" << endl;
+		if (threads == cores) break;
+	}
+}
 int main(int argc, char* argv[])
 {
 	using namespace std;
 	string code;
 	Grammar g;
+	if (argc > 1 && string(argv[1]) == "bench")
+	{
+		BenchBatch(g);
+		return 0;
+	}
+	if (argc > 1 && string(argv[1]) == "check") return RunChecks();
 	while (true)
 	{
 		{
@@ -114,14 +683,21 @@ int main(int argc, char* argv[])
 			code = string(istreambuf_iterator<char>(fs), istreambuf_iterator<char>());
 			fs.close();
 			U32Itor begin(code.begin()), end(code.end());
-			auto result = parser::Parse(begin, end, g);
-			if (!result.IsNull() && begin == end)
+			try
 			{
-				cout << "Success:" << result.Get();
+				auto report = parser::ParseWithReport(begin, end, g);
+				if (!report.value.IsNull() && begin == end)
+				{
+					cout << "Success:" << report.value.Get();
+				}
+				else
+				{
+					cout << "[Error]" << report.farthest.Error().what();
+				}
 			}
-			else
+			catch (ParseError const& e)
 			{
-				cout << "[Error]Line " << begin.Line() << ", Col " << begin.Col() << ".";
+				cout << "[Error]" << e.what();
 			}
 		}
 		
@@ -0,0 +1,306 @@
+#include <cstdio>
+
+#include "parser/Analyzer.h"
+#include "parser/Dfa.h"
+#include "parser/Precedence.h"
+#include "parser/Symbols.h"
+namespace em
+{
+	namespace parser
+	{
+		namespace
+		{
+			String _Char(CharT c)
+			{
+				if (c >= 0x20 && c < 0x7F) return String("'") + (char)c + "'";
+				char buf[16];
+				std::snprintf(buf, sizeof(buf), "U+%04X", (unsigned)c);
+				return buf;
+			}
+			String _RuleName(ExprBase const* ref)
+			{
+				String name = ref->Describe();
+				return name.empty() ? String("an unnamed rule") : "rule '" + name + "'";
+			}
+		}
+
+		Analyzer::Analyzer(ExprBase const* r) : root(r)
+		{
+			Set<ExprBase const*> seen;
+			Vector<ExprBase const*> todo{ root };
+			while (!todo.empty())
+			{
+				auto at = todo.back();
+				todo.pop_back();
+				if (!at || !seen.insert(at).second) continue;
+				nodes.push_back(at);
+				at->Children(todo);
+			}
+			// Rules may refer to each other, grow the nullable set to a fixpoint.
+			for (bool changed = true; changed;)
+			{
+				changed = false;
+				for (auto n : nodes)
+					if (!nullable.count(n) && _Nullable(n))
+					{
+						nullable.insert(n);
+						changed = true;
+					}
+			}
+		}
+
+		bool Analyzer::IsNullable(ExprBase const* e) const
+		{
+			return 0 != nullable.count(e);
+		}
+
+		bool Analyzer::_Nullable(ExprBase const* e) const
+		{
+			Vector<ExprBase const*> children;
+			e->Children(children);
+			switch (e->Kind())
+			{
+			case ExprKind::Sequ:
+			case ExprKind::Expect:
+			case ExprKind::Chain:
+				for (auto c : children) if (!IsNullable(c)) return false;
+				return true;
+			case ExprKind::Alt:
+				for (auto c : children) if (IsNullable(c)) return true;
+				return false;
+			case ExprKind::Rep:
+			case ExprKind::Fold:
+			{
+				uint32_t min;
+				int32_t max;
+				e->Bounds(min, max);
+				return 0 == min || IsNullable(children[0]);
+			}
+			case ExprKind::Ref:
+			case ExprKind::Action:
+			case ExprKind::Recover:
+			case ExprKind::Breaker:
+			case ExprKind::Skip:
+			case ExprKind::Precedence:
+			case ExprKind::Capture:
+				return !children.empty() && IsNullable(children[0]);
+			default:
+				return e->AcceptsEmpty();
+			}
+		}
+
+		void Analyzer::_Left(ExprBase const* e, bool all, Vector<ExprBase const*>& out) const
+		{
+			Vector<ExprBase const*> children;
+			e->Children(children);
+			switch (e->Kind())
+			{
+			case ExprKind::Sequ:
+			case ExprKind::Expect:
+			case ExprKind::Chain:
+				for (auto c : children)
+				{
+					out.push_back(c);
+					if (!IsNullable(c)) break;
+				}
+				break;
+			case ExprKind::Breaker:
+			case ExprKind::Skip:
+				out.push_back(children[0]);
+				if (all && children.size() > 1) out.push_back(children[1]);
+				break;
+			case ExprKind::Rep:
+			case ExprKind::Fold:
+				// A separator only runs after the first element.
+				out.push_back(children[0]);
+				break;
+			case ExprKind::Precedence:
+				// The operand or a prefix operator comes first, infix and
+				// postfix operators only follow an operand.
+				out.insert(out.end(), children.begin(), children.begin() + 1
+					+ dynamic_cast<PrecedenceBase const*>(e)->Prefixes());
+				break;
+			default:
+				out.insert(out.end(), children.begin(), children.end());
+			}
+		}
+
+		CharSet Analyzer::First(ExprBase const* e) const
+		{
+			CharSet ret("");	// CharSet() would be any character.
+			Set<ExprBase const*> seen;
+			Vector<ExprBase const*> todo{ e };
+			while (!todo.empty())
+			{
+				auto at = todo.back();
+				todo.pop_back();
+				if (!seen.insert(at).second) continue;
+				at->FirstChars(ret);
+				_Left(at, false, todo);
+			}
+			return ret;
+		}
+
+		void Analyzer::_LeftCycles(ExprBase const* e, std::map<ExprBase const*, int>& state,
+			Vector<ExprBase const*>& path, Vector<Vector<ExprBase const*>>& cycles) const
+		{
+			state[e] = 1;
+			path.push_back(e);
+			Vector<ExprBase const*> next;
+			_Left(e, true, next);
+			for (auto n : next)
+			{
+				int s = state[n];
+				if (1 == s) cycles.emplace_back(std::find(path.begin(), path.end(), n), path.end());
+				else if (0 == s) _LeftCycles(n, state, path, cycles);
+			}
+			path.pop_back();
+			state[e] = 2;
+		}
+
+		Vector<GrammarIssue> Analyzer::Issues(String const& start) const
+		{
+			using Type = GrammarIssue::Type;
+			Vector<GrammarIssue> ret;
+			if (!root)
+			{
+				ret.push_back({ Type::UnassignedRule, start, "The start rule is never assigned." });
+				return ret;
+			}
+
+			// Each expression is reported under the first named rule it is found in.
+			std::map<ExprBase const*, String> owner;
+			Vector<ExprBase const*> order, children;
+			Vector<std::pair<ExprBase const*, String>> todo{ { root, start } };
+			while (!todo.empty())
+			{
+				auto at = todo.back();
+				todo.pop_back();
+				if (!at.first || owner.count(at.first)) continue;
+				owner[at.first] = at.second;
+				order.push_back(at.first);
+				String name = ExprKind::Ref == at.first->Kind() && !at.first->Describe().empty()
+					? at.first->Describe() : at.second;
+				children.clear();
+				at.first->Children(children);
+				for (auto i = children.rbegin(); i != children.rend(); ++i)
+					todo.push_back({ *i, name });
+			}
+
+			for (auto e : order)
+			{
+				String const& rule = owner[e];
+				children.clear();
+				e->Children(children);
+				switch (e->Kind())
+				{
+				case ExprKind::Ref:
+					if (children.empty())
+						ret.push_back({ Type::UnassignedRule, rule,
+							_RuleName(e) + " is used but never assigned." });
+					break;
+				case ExprKind::Rep:
+				case ExprKind::Fold:
+				{
+					uint32_t min;
+					int32_t max;
+					e->Bounds(min, max);
+					// A separator that consumes input ends the repetition too.
+					bool empty = true;
+					for (auto c : children) empty = empty && IsNullable(c);
+					if (-1 == max && empty)
+					{
+						String what = children[0]->Describe();
+						ret.push_back({ Type::EndlessRepeat, rule, "An unbounded repetition of "
+							+ (what.empty() ? String("an expression") : what)
+							+ " can match empty input and loop forever." });
+					}
+					break;
+				}
+				case ExprKind::Alt:
+				{
+					// Alternatives that start alike are compared as automata when
+					// both are regular. Sharing a start only costs backtracking,
+					// an earlier one matching the start of a later one's input
+					// takes that input from it.
+					Vector<CharSet> firsts;
+					for (auto c : children) firsts.push_back(First(c));
+					String hides, shares;
+					for (size_t j = 1; j < firsts.size(); j++)
+						for (size_t i = 0; i < j; i++)
+						{
+							CharT at;
+							bool empty = IsNullable(children[i]);
+							if (!empty && !firsts[i].Intersects(firsts[j], &at)) continue;
+							Dfa dfa;
+							bool known = dfa.Add(children[i], 0) && dfa.Add(children[j], 1) && dfa.Build();
+							if (empty || (known && dfa.Shadows(0, 1)))
+							{
+								hides += (hides.empty() ? "" : ", ") + std::to_string(i + 1)
+									+ " before " + std::to_string(j + 1);
+								break;
+							}
+							if (known) continue;
+							shares += (shares.empty() ? "" : ", ") + std::to_string(i + 1)
+								+ " and " + std::to_string(j + 1) + " on " + _Char(at);
+							break;
+						}
+					if (!hides.empty())
+						ret.push_back({ Type::OverlappingChoice, rule,
+							"An alternative matches the start of a later one's input, which never gets it: "
+							+ hides + "." });
+					if (!shares.empty())
+						ret.push_back({ Type::SharedStart, rule,
+							"Alternatives start alike and may backtrack: " + shares + "." });
+					break;
+				}
+				case ExprKind::Symbols:
+				{
+					// Literal alternatives are fused into ordered keys, where a
+					// key that starts a later one takes its input the same way.
+					auto sym = dynamic_cast<SymbolsBase const*>(e);
+					if (!sym || MatchMode::Ordered != sym->Mode() || sym->HasBoundary()) break;
+					Vector<String> keys = sym->Keys();
+					String hides;
+					for (size_t j = 1; j < keys.size(); j++)
+						for (size_t i = 0; i < j; i++)
+							if (!keys[j].compare(0, keys[i].size(), keys[i]))
+							{
+								hides += (hides.empty() ? "\"" : ", \"") + keys[i]
+									+ "\" before \"" + keys[j] + '"';
+								break;
+							}
+					if (!hides.empty())
+						ret.push_back({ Type::OverlappingChoice, rule,
+							"An alternative matches the start of a later one's input, which never gets it: "
+							+ hides + "." });
+					break;
+				}
+				default:
+					break;
+				}
+			}
+
+			std::map<ExprBase const*, int> state;
+			Vector<ExprBase const*> path;
+			Vector<Vector<ExprBase const*>> cycles;
+			_LeftCycles(root, state, path, cycles);
+			for (auto& cycle : cycles)
+			{
+				String names;
+				ExprBase const* first = nullptr;
+				for (auto e : cycle)
+				{
+					if (ExprKind::Ref != e->Kind()) continue;
+					if (!first) first = e;
+					names += (names.empty() ? "" : " -> ") + _RuleName(e);
+				}
+				if (!first) continue;
+				names += " -> " + _RuleName(first);
+				ret.push_back({ Type::LeftRecursion, owner[first],
+					"Left recursion without consuming input: " + names + "." });
+			}
+			return ret;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include <map>
+
+#include "parser/CharSet.h"
+namespace em
+{
+	namespace parser
+	{
+		struct GrammarIssue
+		{
+			enum class Type
+			{
+				UnassignedRule,		// A rule is used but never assigned.
+				EndlessRepeat,		// An unbounded repetition may match empty input.
+				LeftRecursion,		// A rule reaches itself without consuming input.
+				OverlappingChoice,	// An alternative matches the start of a later one's input.
+				SharedStart			// A note: alternatives start alike and may backtrack.
+			};
+			Type type;
+			String rule;			// The nearest named rule.
+			String message;
+		};
+
+		// Computes nullability and FIRST sets over an expression graph and looks
+		// for constructs that fail at run time or backtrack a lot. Skippers do
+		// not count towards FIRST sets.
+		struct Analyzer
+		{
+			Analyzer(ExprBase const* root);
+			// Whether the expression can match empty input.
+			bool IsNullable(ExprBase const* e) const;
+			// The characters a match of the expression can start with.
+			CharSet First(ExprBase const* e) const;
+			// 'start' names the root for the report.
+			Vector<GrammarIssue> Issues(String const& start) const;
+		private:
+			ExprBase const* root;
+			Vector<ExprBase const*> nodes;
+			Set<ExprBase const*> nullable;
+			bool _Nullable(ExprBase const* e) const;
+			// The parts that run at the same position as the expression. With
+			// 'all' set, skippers and breakers are included.
+			void _Left(ExprBase const* e, bool all, Vector<ExprBase const*>& out) const;
+			void _LeftCycles(ExprBase const* e, std::map<ExprBase const*, int>& state,
+				Vector<ExprBase const*>& path, Vector<Vector<ExprBase const*>>& cycles) const;
+		};
+	}
+}
\ No newline at end of file
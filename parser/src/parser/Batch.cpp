@@ -0,0 +1,263 @@
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "parser/Batch.h"
+namespace em
+{
+	namespace parser
+	{
+		namespace
+		{
+			// The jobs a thread has left, taken from the front by the thread and
+			// from the back by thieves.
+			struct _Share
+			{
+				std::mutex lock;
+				// Written under the lock, read without it to pick a victim.
+				std::atomic<size_t> from{ 0 }, to{ 0 };
+			};
+
+			bool _Take(_Share& s, size_t& job)
+			{
+				std::lock_guard<std::mutex> guard(s.lock);
+				if (s.from == s.to) return false;
+				job = s.from++;
+				return true;
+			}
+			// Moves the back half of the largest other share to 'self'.
+			bool _Steal(Vector<_Share>& shares, uint32_t self)
+			{
+				while (true)
+				{
+					uint32_t victim = self;
+					size_t most = 0;
+					for (uint32_t i = 0; i < shares.size(); i++)
+					{
+						if (i == self) continue;
+						size_t to = shares[i].to, from = shares[i].from;
+						size_t left = to > from ? to - from : 0;
+						if (left > most)
+						{
+							most = left;
+							victim = i;
+						}
+					}
+					if (victim == self) return false;
+					size_t from, to;
+					{
+						std::lock_guard<std::mutex> guard(shares[victim].lock);
+						_Share& v = shares[victim];
+						if (v.from == v.to) continue;
+						to = v.to;
+						from = v.to - (v.to - v.from + 1) / 2;
+						v.to = from;
+					}
+					std::lock_guard<std::mutex> guard(shares[self].lock);
+					shares[self].from = from;
+					shares[self].to = to;
+					return true;
+				}
+			}
+
+			// The first occurrence of 'pattern' in [p, last), or null.
+			char const* _Find(char const* p, char const* last, String const& pattern)
+			{
+				for (; (p = (char const*)std::memchr(p, pattern[0], last - p)); p++)
+				{
+					if ((size_t)(last - p) < pattern.size()) return nullptr;
+					if (0 == std::memcmp(p, pattern.data(), pattern.size())) return p;
+				}
+				return nullptr;
+			}
+		}
+
+		uint32_t WorkPool::Threads(uint32_t threads, size_t count)
+		{
+			if (0 == threads) threads = std::max(1u, std::thread::hardware_concurrency());
+			return (uint32_t)std::max<size_t>(1, std::min<size_t>(threads, count));
+		}
+
+		void WorkPool::Run(size_t count, uint32_t threads,
+			Function<void(uint32_t thread, size_t job)> const& job)
+		{
+			threads = Threads(threads, count);
+			Vector<_Share> shares(threads);
+			for (uint32_t i = 0; i < threads; i++)
+			{
+				shares[i].from = count * i / threads;
+				shares[i].to = count * (i + 1) / threads;
+			}
+			std::atomic<bool> failed{ false };
+			std::exception_ptr error;
+			std::mutex errorLock;
+			auto work = [&](uint32_t self)
+			{
+				size_t at;
+				while (!failed)
+				{
+					if (!_Take(shares[self], at) && !(_Steal(shares, self) && _Take(shares[self], at)))
+						return;
+					try { job(self, at); }
+					catch (...)
+					{
+						std::lock_guard<std::mutex> guard(errorLock);
+						if (!error) error = std::current_exception();
+						failed = true;
+					}
+				}
+			};
+			Vector<std::thread> pool;
+			for (uint32_t i = 1; i < threads; i++) pool.emplace_back(work, i);
+			work(0);
+			for (auto& t : pool) t.join();
+			if (error) std::rethrow_exception(error);
+		}
+
+		thread_local bool SplitBase::inside = false;
+
+		bool IdMap::Same() const
+		{
+			for (uint32_t i = 0; i < strings.size(); i++)
+				if (strings[i] != i) return false;
+			for (uint32_t i = 0; i < ids.size(); i++)
+				if (ids[i] != i) return false;
+			return true;
+		}
+
+		IdMap SplitBase::Map(ParseContext const& to, ParseContext const& chunk)
+		{
+			return IdMap{ to.strings.Ids(chunk.strings), to.ids.Ids(chunk.ids) };
+		}
+		void SplitBase::Join(ParseContext& to, ParseContext const& chunk)
+		{
+			for (auto& str : chunk.strings.store) to.strings.Intern(str.data(), str.size());
+			for (auto& str : chunk.ids.store) to.ids.Intern(str.data(), str.size());
+			to.TakeErrors(chunk);
+		}
+
+		namespace
+		{
+			// Goes over [p, last) from inside quotes or not and calls f(p, in) at
+			// each byte that is not escaped and is not in 'plain' or is 'lead'.
+			// Runs of plain bytes are skipped in bulk. Stops where 'f' returns true.
+			template <typename F>
+			char const* _Walk(char const* p, char const* last, bool in, SplitSyntax const& syntax,
+				CharSet const& plain, char lead, F const& f)
+			{
+				while (p < last)
+				{
+					p += plain.Prefix(p, last - p);
+					if (p == last) break;
+					if ((uint8_t)*p >= 0x80 && *p != lead) p++;
+					else if (syntax.escape && syntax.escape == *p) p += 2;
+					else
+					{
+						if (f(p, in)) return p;
+						if (syntax.quote && syntax.quote == *p) in = !in;
+						p++;
+					}
+				}
+				return last;
+			}
+			// How a share changes the state, for both states it may start in.
+			struct _Summary
+			{
+				bool flips = false;				// An odd number of quotes.
+				int64_t depth[2] = { 0, 0 };	// Starting outside quotes, inside.
+			};
+			int _Bracket(SplitSyntax const& syntax, char c)
+			{
+				size_t i = syntax.brackets.find(c);
+				if (String::npos == i) return 0;
+				return i % 2 ? -1 : 1;
+			}
+		}
+
+		Vector<std::string::iterator> SplitBase::Cuts(std::string::iterator from, std::string::iterator to) const
+		{
+			Vector<std::string::iterator> ret;
+			size_t size = to - from;
+			size_t most = minChunk ? size / minChunk : size;
+			uint32_t pool = WorkPool::Threads(threads, most);
+			if (sync.empty() || pool < 2) return ret;
+			// A few chunks a thread, so the ones that finish early can steal.
+			size_t chunks = std::min<size_t>(pool * 4, most);
+			char const* first = &*from;
+			char const* last = first + size;
+			// Where the sync pattern is found after each share starts.
+			Vector<char const*> found(chunks, nullptr);
+			if (!syntax.quote && syntax.brackets.empty())
+			{
+				char const* at = first;
+				for (size_t i = 1; i < chunks && at != last; i++)
+				{
+					found[i] = _Find(std::max(at, first + size * i / chunks), last, sync);
+					if (!found[i]) break;
+					at = found[i] + sync.size();
+				}
+			}
+			else
+			{
+				// No escape is cut from the byte it takes.
+				Vector<char const*> shares{ first };
+				for (size_t i = 1; i < chunks; i++)
+				{
+					char const* p = std::max(shares.back(), first + size * i / chunks);
+					while (syntax.escape && p < last && syntax.escape == p[-1]) p++;
+					shares.push_back(p);
+				}
+				shares.push_back(last);
+				CharSet special("");
+				for (char c : syntax.brackets + syntax.quote + syntax.escape + sync[0])
+					if (c) special = special | CharSet{ CharRange((CharT)(uint8_t)c) };
+				CharSet plain = ~special;
+				Vector<_Summary> sums(chunks);
+				WorkPool::Run(chunks, pool, [&](uint32_t, size_t i)
+				{
+					_Walk(shares[i], shares[i + 1], false, syntax, plain, sync[0], [&](char const* p, bool in)
+					{
+						sums[i].depth[in] += _Bracket(syntax, *p);
+						if (syntax.quote == *p) sums[i].flips = !sums[i].flips;
+						return false;
+					});
+				});
+				Vector<bool> quoted(chunks, false);
+				Vector<int64_t> depth(chunks, 0);
+				for (size_t i = 1; i < chunks; i++)
+				{
+					quoted[i] = quoted[i - 1] != sums[i - 1].flips;
+					depth[i] = depth[i - 1] + sums[i - 1].depth[quoted[i - 1]];
+				}
+				WorkPool::Run(chunks - 1, pool, [&](uint32_t, size_t k)
+				{
+					size_t i = k + 1;
+					int64_t d = depth[i];
+					_Walk(shares[i], shares[i + 1], quoted[i], syntax, plain, sync[0], [&](char const* p, bool in)
+					{
+						if (in) return false;
+						if (0 == d && (size_t)(last - p) >= sync.size() && 0 == std::memcmp(p, sync.data(), sync.size()))
+						{
+							found[i] = p;
+							return true;
+						}
+						d += _Bracket(syntax, *p);
+						return false;
+					});
+				});
+			}
+			for (auto p : found)
+			{
+				if (!p) continue;
+				char const* at = p + sync.size();
+				if (at == last || (!ret.empty() && from + (at - first) <= ret.back())) continue;
+				// U32Itor reads a '\r' together with the character after it.
+				if ('\r' == at[-1]) continue;
+				ret.push_back(from + (at - first));
+			}
+			return ret;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,273 @@
+#pragma once
+#include "parser/GrammarBase.h"
+#include "parser/Lexer.h"
+namespace em
+{
+	namespace parser
+	{
+		// Runs jobs 0 to count - 1 on threads, the calling one included. Each
+		// thread starts on an even share of the jobs, and one that runs out
+		// steals the back half of the largest share left. An exception thrown
+		// by a job stops the pool and is thrown again by Run.
+		struct WorkPool
+		{
+			// 0 threads means one per core. No more threads than jobs are started.
+			static uint32_t Threads(uint32_t threads, size_t count);
+			static void Run(size_t count, uint32_t threads,
+				Function<void(uint32_t thread, size_t job)> const& job);
+		};
+
+		// Parses every input with one grammar on a WorkPool and calls
+		// f(index, value, context) on the thread that parsed it, as soon as it
+		// is parsed, so calls come in no order. Each thread keeps one
+		// ParseContext for all its inputs; ids in 'value' are valid in
+		// 'context' until 'f' returns. 'value' is null when the input does not
+		// match to its end or a cut fails in it. F must take those arguments,
+		// so a thread count in its place picks the overload below.
+		template <typename Out, typename F, typename = decltype(std::declval<F const&>()(size_t(0),
+			std::declval<Nullable<WarpVoid<Out>>&>(), std::declval<ParseContext&>()))>
+		inline void ParseBatch(GrammarBase<Out>& g, Vector<String> const& inputs, F const& f, uint32_t threads = 0)
+		{
+			threads = WorkPool::Threads(threads, inputs.size());
+			Vector<ParseContext> contexts(threads);
+			WorkPool::Run(inputs.size(), threads, [&](uint32_t thread, size_t i)
+			{
+				ParseContext& ctx = contexts[thread];
+				// The parser only reads, and spans in 'value' point into the input.
+				String& text = const_cast<String&>(inputs[i]);
+				U32Itor input(text.begin()), end(text.end());
+				Nullable<WarpVoid<Out>> value;
+				try
+				{
+					value = g.Parse(input, end, nullptr, ctx);
+					if (input != end) value = null;
+				}
+				catch (ParseError const&) { value = null; }
+				f(i, value, ctx);
+			});
+		}
+		// Returns the values in the order of the inputs.
+		template <typename Out>
+		inline Vector<Nullable<WarpVoid<Out>>> ParseBatch(GrammarBase<Out>& g,
+			Vector<String> const& inputs, uint32_t threads = 0)
+		{
+			Vector<Nullable<WarpVoid<Out>>> ret(inputs.size());
+			ParseBatch(g, inputs, [&](size_t i, Nullable<WarpVoid<Out>>& value, ParseContext&)
+			{
+				ret[i] = std::move(value);
+			}, threads);
+			return ret;
+		}
+
+		// The lexical structure split_ keeps to when it cuts: a sync pattern
+		// inside quotes or brackets is not a cut. The characters are ASCII.
+		struct SplitSyntax
+		{
+			char quote = 0;
+			// Takes the byte after it as it is, inside quotes or not.
+			char escape = 0;
+			// Opening and closing pairs, like "[]{}".
+			String brackets;
+		};
+
+		// How the ids a split_ chunk stored map to the ones a sequential parse
+		// gives: string id i becomes strings[i], id i becomes ids[i].
+		struct IdMap
+		{
+			Vector<uint32_t> strings, ids;
+			bool Same() const;
+		};
+
+		// What split_ needs besides its record: where to cut the input.
+		struct SplitBase
+		{
+			String sync;
+			SplitSyntax syntax;
+			uint32_t threads;
+			size_t minChunk;
+			SplitBase(String const& s, SplitSyntax const& x, uint32_t t, size_t m)
+				: sync(s), syntax(x), threads(t), minChunk(m) {}
+			// Where the chunks after the first start, right after a sync pattern
+			// near each even share. Empty when the input is too small to split.
+			// With a syntax, the quote and bracket state at each share is found
+			// first: every share is scanned once on the pool for both states it
+			// may start in, and the states are then chained from the start.
+			Vector<std::string::iterator> Cuts(std::string::iterator from, std::string::iterator to) const;
+			// How the ids of a chunk's context map once it is joined to 'to'.
+			static IdMap Map(ParseContext const& to, ParseContext const& chunk);
+			// Moves the strings, ids and errors of a chunk's context to 'to'.
+			static void Join(ParseContext& to, ParseContext const& chunk);
+			// Set on the threads parsing chunks, where split_ does not split again.
+			static thread_local bool inside;
+			struct Inside
+			{
+				bool prev;
+				Inside() : prev(inside) { inside = true; }
+				~Inside() { inside = prev; }
+			};
+		};
+
+		// Parses like '*record', but cuts large inputs right after occurrences
+		// of the sync pattern and parses the chunks on a WorkPool. The pattern
+		// must only occur between records. Each chunk starts with the line and
+		// column a sequential parse would have there, and stores to a context
+		// of its own; the contexts are joined in order. A chunk that does not
+		// end at its cut, or whose ids differ from a sequential parse with no
+		// 'renumber' to fix its values, is parsed again from its start on this
+		// thread, up to the end. So the values are the same as a sequential
+		// parse gives. Without a context to join to, it does not split.
+		template <typename Out>
+		struct SplitExpr : Expr<Vector<Out>>, SplitBase
+		{
+			using Result = Vector<Out>;
+			using Renumber = Function<void(Out&, IdMap const&)>;
+			Ptr<Expr<Out>> record;
+			Renumber renumber;
+			SplitExpr(Ptr<Expr<Out>> const& r, String const& sync, SplitSyntax const& syntax,
+				Renumber const& f, uint32_t threads, size_t minChunk)
+				: SplitBase(sync, syntax, threads, minChunk), record(r), renumber(f) {}
+			virtual ExprKind Kind() const { return ExprKind::Rep; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(record.get()); }
+			virtual bool AcceptsEmpty() const { return true; }
+			virtual void Bounds(uint32_t& min, int32_t& max) const { min = 0; max = -1; }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(record); }
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				Vector<Out> ret;
+				ParseContext* ctx = ParseContext::current;
+				auto cuts = inside || !ctx ? Vector<std::string::iterator>() : Cuts(input.Base(), end.Base());
+				if (!cuts.empty())
+				{
+					size_t count = cuts.size() + 1, next = 0;
+					// Lines are counted in bulk between the cuts.
+					Vector<Ptr<U32Itor>> starts{ std::make_shared<U32Itor>(input) };
+					for (auto& cut : cuts)
+					{
+						starts.push_back(std::make_shared<U32Itor>(*starts.back()));
+						starts.back()->Advance(cut);
+					}
+					Vector<_Chunk> chunks(count);
+					_Run(starts, end, s, chunks);
+					for (; next < count && chunks[next].done; next++)
+					{
+						_Chunk& c = chunks[next];
+						IdMap map = Map(*ctx, c.context);
+						bool same = map.Same();
+						if (!same && !renumber) break;
+						Join(*ctx, c.context);
+						if (!same)
+							for (auto& v : c.values) renumber(v, map);
+						if (FailureTracker::current) FailureTracker::current->Merge(c.tracker);
+						ret.insert(ret.end(), c.values.begin(), c.values.end());
+					}
+					if (next == count)
+					{
+						input = *chunks.back().stop;
+						return ret;
+					}
+					input = *starts[next];
+				}
+				_Records(input, end, s, ret);
+				return ret;
+			}
+		private:
+			struct _Chunk
+			{
+				Vector<Out> values;
+				bool done = false;
+				Ptr<U32Itor> stop;
+				FailureTracker tracker;
+				ParseContext context;
+			};
+			// Parses the chunks on a WorkPool with the thread's tracker and tokens,
+			// each chunk storing to its own context.
+			void _Run(Vector<Ptr<U32Itor>> const& starts, U32Itor const& end, Ptr<Expr<Void>> const& s,
+				Vector<_Chunk>& chunks)
+			{
+				bool track = nullptr != FailureTracker::current;
+				TokenStream const* tokens = TokenStream::current;
+				WorkPool::Run(chunks.size(), threads, [&](uint32_t, size_t k)
+				{
+					Inside in;
+					_Chunk& c = chunks[k];
+					FailureTracker::Scope ts(track ? &c.tracker : nullptr);
+					ParseContext::Scope cs(&c.context);
+					TokenStream::Scope ks(tokens);
+					U32Itor at(*starts[k]);
+					try
+					{
+						if (k + 1 < chunks.size()) c.done = _Records(at, *starts[k + 1], s, c.values);
+						else
+						{
+							// The last chunk stops where a sequential parse would.
+							_Records(at, end, s, c.values);
+							c.done = true;
+						}
+					}
+					catch (ParseError const&) { c.done = false; }
+					c.stop = std::make_shared<U32Itor>(at);
+				});
+			}
+			// Parses records up to 'end'. True when the record after the last
+			// one fails at 'end' only for lack of input, so the next chunk goes
+			// on where a sequential parse would.
+			bool _Records(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s, Vector<Out>& out)
+			{
+				while (true)
+				{
+					U32Itor before(input);
+					Nullable<Out> res = record->Parse(input, end, s);
+					if (res.IsNull())
+					{
+						RunSkipper(s, before, end);
+						return before == end;
+					}
+					out.push_back(res.Get());
+				}
+			}
+		};
+
+		// 'renumber' maps the ids in a value parsed on another thread to the
+		// ones a sequential parse gives, so chunks that store ids need not be
+		// parsed again.
+		template <typename Out>
+		inline Node<Vector<Out>> split_(Node<Out> const& record, char const* sync, SplitSyntax const& syntax,
+			typename SplitExpr<Out>::Renumber const& renumber, uint32_t threads = 0, size_t minChunk = 1 << 18)
+		{
+			return Node<Vector<Out>>{
+				std::make_shared<SplitExpr<Out>>(record.expr, sync, syntax, renumber, threads, minChunk) };
+		}
+		template <typename Out>
+		inline Node<Vector<WarpVoid<Out>>> split_(Rule<Out>& record, char const* sync, SplitSyntax const& syntax,
+			typename SplitExpr<WarpVoid<Out>>::Renumber const& renumber, uint32_t threads = 0,
+			size_t minChunk = 1 << 18)
+		{
+			return Node<Vector<WarpVoid<Out>>>{
+				std::make_shared<SplitExpr<WarpVoid<Out>>>(record.Alias(), sync, syntax, renumber, threads, minChunk) };
+		}
+		template <typename Out>
+		inline Node<Vector<Out>> split_(Node<Out> const& record, char const* sync, SplitSyntax const& syntax,
+			uint32_t threads = 0, size_t minChunk = 1 << 18)
+		{
+			return split_(record, sync, syntax, nullptr, threads, minChunk);
+		}
+		template <typename Out>
+		inline Node<Vector<WarpVoid<Out>>> split_(Rule<Out>& record, char const* sync, SplitSyntax const& syntax,
+			uint32_t threads = 0, size_t minChunk = 1 << 18)
+		{
+			return split_(record, sync, syntax, nullptr, threads, minChunk);
+		}
+		template <typename Out>
+		inline Node<Vector<Out>> split_(Node<Out> const& record, char const* sync,
+			uint32_t threads = 0, size_t minChunk = 1 << 18)
+		{
+			return split_(record, sync, SplitSyntax(), threads, minChunk);
+		}
+		template <typename Out>
+		inline Node<Vector<WarpVoid<Out>>> split_(Rule<Out>& record, char const* sync,
+			uint32_t threads = 0, size_t minChunk = 1 << 18)
+		{
+			return split_(record, sync, SplitSyntax(), threads, minChunk);
+		}
+	}
+}
\ No newline at end of file
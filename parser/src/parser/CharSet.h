@@ -10,30 +10,85 @@ namespace em
 			using CharType = CharT;
 			CharT from, to;
 
-			CharRange(CharT const& c) :from(c), to(c) {}
-			CharRange(CharT const& f, CharT const& t) :from(f), to(t) {}
+			constexpr CharRange(CharT const& c) :from(c), to(c) {}
+			constexpr CharRange(CharT const& f, CharT const& t) :from(f), to(t) {}
 			bool operator<(CharRange const& other) const;
 			bool operator==(CharRange const& other) const;
 		};
+		// A frozen CharSet, shared by copies. The ranges are sorted and apart,
+		// 'low' has a bit for each character below 0x800 with the exception
+		// resolved. Unicode property tables are generated as constants of it.
+		struct CharTable
+		{
+			CharRange const* ranges;
+			uint32_t count;
+			uint64_t low[32];
+			// By low nibble, a bit for each high nibble of an ASCII character in
+			// 'low', for testing 16 or 32 bytes at once with a byte shuffle.
+			uint8_t nibbles[16];
+		};
 		struct CharSet
 		{
 		private:
-			Ptr<Set<CharRange>> set = std::make_shared<Set<CharRange>>();
+			CharTable const* table = &_any;
+			// Holds 'table' when it was built at run time.
+			Ptr<CharTable const> owned;
 			bool except = true;
-			inline void _Add(CharRange const& r);
+			// Ranges are collected in a Set, which merges them, then frozen.
+			static void _Add(Set<CharRange>& set, CharRange const& r);
 			template <typename Char>
-			inline void _AddStr(Char const* str);
+			static void _AddStr(Set<CharRange>& set, Char const* str);
+			void _Freeze(Set<CharRange> const& set);
+			static const CharTable _any;
+			bool _Search(CharT c) const;
 		public:
 			using CharType = CharT;
 			CharSet() {}
-			CharSet(CharSet const& other)
-				:set(other.set), except(other.except) {}
 			CharSet(std::initializer_list<CharRange> l);
 			CharSet(char const* str);
 			CharSet(wchar_t const* str);
 			CharSet(char32_t const* str);
+			// Uses a table that outlives the set, such as a generated one,
+			// without copying it. Sets of generated tables are built at compile
+			// time.
+			constexpr CharSet(CharTable const& t) : table(&t), except(false) {}
 
+			bool IsAny() const;
+			// The ranges matched, sorted, with the exception resolved.
+			Vector<CharRange> Ranges() const;
+			// Like "[a-z_]", for error messages.
+			String Describe() const;
+			// The characters in either set.
+			CharSet operator|(CharSet const& other) const;
+			// The characters in both sets.
+			CharSet operator&(CharSet const& other) const;
+			// The characters in this set but not in the other.
+			CharSet operator-(CharSet const& other) const;
+			// The characters not in this set.
+			CharSet operator~() const;
+			// Whether a character is in both sets, the lowest one goes to 'at'.
+			bool Intersects(CharSet const& other, CharT* at = nullptr) const;
 			bool Has(CharRange const& r) const;
+			bool Has(CharT const& c) const
+			{
+				if (c < 0x800) return 0 != (table->low[c >> 6] & (1ull << (c & 63)));
+				return _Search(c);
+			}
+			// How many of the 'n' bytes at 'p' are ASCII members before the first
+			// that is not. Bytes of longer characters never match.
+			size_t Prefix(char const* p, size_t n) const;
+			// The vector instructions Prefix() tests bytes with: the widest the
+			// CPU has on x86, else None. Detected once at startup.
+			enum class Simd { None, Ssse3, Avx2 };
+			static const Simd simd;
+			// Limits Prefix() on this thread to narrower instructions while it
+			// lives, to test those paths. Other threads are not affected.
+			struct Narrow
+			{
+				Simd prev;
+				Narrow(Simd s) : prev(limit) { limit = s; }
+				~Narrow() { limit = prev; }
+			};
 			Node<Vector<CharType>> operator*() const;
 			Node<Vector<CharType>> operator-() const;
 			Node<Vector<CharType>> operator+() const;
@@ -75,15 +130,21 @@ namespace em
 				};
 			}
 			Node<char32_t> operator>>(CharSet const&) const;
-
+		private:
+			static thread_local Simd limit;
 		};
 
+		extern const CharSet XID_Start, XID_Continue;
+
 		struct CharSetExpr : Expr<char32_t>
 		{
 			using Result = char32_t;
 			CharSet set;
 			CharSetExpr(const CharSet& set) : set(set) {}
 			CharSetExpr(CharSet&& set) :set(std::move(set)) {}
+			virtual ExprKind Kind() const { return ExprKind::CharSet; }
+			virtual void FirstChars(CharSet& out) const { out = out | set; }
+			virtual String Describe() const { return set.Describe(); }
 			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s);
 		};
 
@@ -92,6 +153,38 @@ namespace em
 			using Result = Void;
 			CharSet skip;
 			SkipCharExpr(CharSet const& s) : skip(s) {}
+			virtual ExprKind Kind() const { return ExprKind::SkipChar; }
+			virtual void FirstChars(CharSet& out) const { out = out | skip; }
+			virtual String Describe() const { return skip.Describe(); }
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s);
+		};
+
+		// Matches a run of characters from a charset and returns it as a Span.
+		// The skipper runs once before the run, not between its characters.
+		struct SpanExpr : Expr<Span>
+		{
+			using Result = Span;
+			CharSet set;
+			uint32_t min, max;
+			SpanExpr(CharSet const& set, uint32_t min, uint32_t max)
+				: set(set), min(min), max(max) {}
+			virtual ExprKind Kind() const { return ExprKind::Span; }
+			virtual bool AcceptsEmpty() const { return 0 == min; }
+			virtual void FirstChars(CharSet& out) const { out = out | set; }
+			virtual String Describe() const { return set.Describe(); }
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s);
+		};
+
+		// Matches an identifier, a start character then any continue characters
+		// as in UAX #31, and returns it as a Span. ASCII is scanned in bulk and
+		// other characters are looked up in the tables.
+		struct IdentExpr : Expr<Span>
+		{
+			using Result = Span;
+			CharSet start, cont;
+			IdentExpr(CharSet const& s, CharSet const& c) : start(s), cont(c) {}
+			virtual void FirstChars(CharSet& out) const { out = out | start; }
+			virtual String Describe() const { return "identifier"; }
 			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s);
 		};
 	}
@@ -1,6 +1,8 @@
 #pragma once
+#include <exception>
 #include <functional>
 #include <set>
+#include <string>
 
 #include <tsl/htrie_set.h>
 #include <tsl/htrie_map.h>
@@ -34,6 +36,33 @@ namespace em
 		struct Void {};
 		struct Location { uint32_t line, col; };
 
+		struct ParseError : std::exception
+		{
+			Location loc;
+			String expected;
+			ParseError(Location const& l, String const& e)
+				: loc(l), expected(e), message("Line " + std::to_string(l.line)
+					+ ", Col " + std::to_string(l.col)
+					+ (e.empty() ? String(": unexpected input.") : ": expected " + e + "."))
+			{}
+			virtual char const* what() const noexcept { return message.c_str(); }
+		private:
+			String message;
+		};
+
+		// The farthest position a parse reached and what was expected there.
+		struct Farthest
+		{
+			Location loc{};
+			Vector<String> expected;		// Sorted, without duplicates.
+			ParseError Error() const
+			{
+				String e;
+				for (auto& s : expected) e += (e.empty() ? "" : " or ") + s;
+				return ParseError(loc, e);
+			}
+		};
+
 		template <typename In, typename Out>
 		using TFuncLoc = Function<Out(In, Location)>;
 
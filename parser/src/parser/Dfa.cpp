@@ -0,0 +1,336 @@
+#include <map>
+
+#include "parser/Dfa.h"
+#include "parser/Symbols.h"
+namespace em
+{
+	namespace parser
+	{
+		const uint32_t Dfa::Dead;
+
+		uint32_t Dfa::_New()
+		{
+			nfa.emplace_back();
+			return (uint32_t)nfa.size() - 1;
+		}
+		void Dfa::_Edge(uint32_t from, CharSet const& set, uint32_t to)
+		{
+			sets.push_back(set);
+			nfa[from].edges.push_back({ (uint32_t)sets.size() - 1, to });
+		}
+
+		bool Dfa::Add(ExprBase const* e, uint32_t tag)
+		{
+			size_t states = nfa.size(), setCount = sets.size();
+			Vector<ExprBase const*> rules;
+			uint32_t from = _New(), to = _New();
+			if (!_Build(e, from, to, rules))
+			{
+				nfa.resize(states);
+				sets.resize(setCount);
+				return false;
+			}
+			nfa[0].eps.push_back(from);
+			nfa[to].tag = tag;
+			return true;
+		}
+
+		// Every part is built between its own states, or between states its
+		// siblings only enter or leave, so loops never leak into them.
+		bool Dfa::_Build(ExprBase const* e, uint32_t from, uint32_t to, Vector<ExprBase const*>& rules)
+		{
+			Vector<ExprBase const*> children;
+			e->Children(children);
+			switch (e->Kind())
+			{
+			case ExprKind::Literal:
+			{
+				auto lit = dynamic_cast<LiteralExpr const*>(e);
+				if (!lit) return false;
+				_Chars(lit->str, from, to);
+				return true;
+			}
+			case ExprKind::Symbols:
+			{
+				// A boundary looks at the character after the key.
+				auto sym = dynamic_cast<SymbolsBase const*>(e);
+				if (!sym || sym->HasBoundary()) return false;
+				for (auto& key : sym->Keys())
+				{
+					Vector<CharT> str;
+					for (U32Itor i(key.begin()), end(key.end()); i != end; ++i) str.push_back(*i);
+					_Chars(str, from, to);
+				}
+				return true;
+			}
+			case ExprKind::CharSet:
+				_Edge(from, static_cast<CharSetExpr const*>(e)->set, to);
+				return true;
+			case ExprKind::SkipChar:
+				_Edge(from, static_cast<SkipCharExpr const*>(e)->skip, to);
+				return true;
+			case ExprKind::Span:
+			{
+				auto span = static_cast<SpanExpr const*>(e);
+				CharSet const& set = span->set;
+				return _Repeat([&](uint32_t a, uint32_t b) { _Edge(a, set, b); return true; },
+					span->min, (int32_t)span->max, from, to);
+			}
+			case ExprKind::Sequ:
+			case ExprKind::Expect:
+			case ExprKind::Chain:
+			{
+				uint32_t at = from;
+				for (size_t i = 0; i < children.size(); i++)
+				{
+					uint32_t n = i + 1 == children.size() ? to : _New();
+					if (!_Build(children[i], at, n, rules)) return false;
+					at = n;
+				}
+				return true;
+			}
+			case ExprKind::Alt:
+				for (auto c : children)
+				{
+					uint32_t in = _New(), out = _New();
+					nfa[from].eps.push_back(in);
+					nfa[out].eps.push_back(to);
+					if (!_Build(c, in, out, rules)) return false;
+				}
+				return true;
+			case ExprKind::Rep:
+			{
+				uint32_t min;
+				int32_t max;
+				e->Bounds(min, max);
+				ExprBase const* elem = children[0];
+				auto one = [&](uint32_t a, uint32_t b) { return _Build(elem, a, b, rules); };
+				if (children.size() < 2) return _Repeat(one, min, max, from, to);
+				// Separated: one element, then the rest each after a separator.
+				ExprBase const* sep = children[1];
+				auto tail = [&](uint32_t a, uint32_t b)
+				{
+					uint32_t m = _New();
+					return _Build(sep, a, m, rules) && _Build(elem, m, b, rules);
+				};
+				if (0 == min) nfa[from].eps.push_back(to);
+				if (0 == max) return true;
+				uint32_t first = _New();
+				return _Build(elem, from, first, rules)
+					&& _Repeat(tail, min ? min - 1 : 0, -1 == max ? -1 : max - 1, first, to);
+			}
+			case ExprKind::Ref:
+				if (children.empty() || std::find(rules.begin(), rules.end(), e) != rules.end())
+					return false;
+				rules.push_back(e);
+				if (!_Build(children[0], from, to, rules)) return false;
+				rules.pop_back();
+				return true;
+			case ExprKind::Action:
+			case ExprKind::Capture:
+				return _Build(children[0], from, to, rules);
+			case ExprKind::Skip:
+				// Only a cleared skipper keeps the characters as they are.
+				return 1 == children.size() && _Build(children[0], from, to, rules);
+			default:
+				return false;
+			}
+		}
+
+		void Dfa::_Chars(Vector<CharT> const& str, uint32_t from, uint32_t to)
+		{
+			uint32_t at = from;
+			for (size_t i = 0; i < str.size(); i++)
+			{
+				uint32_t n = i + 1 == str.size() ? to : _New();
+				_Edge(at, CharSet{ CharRange(str[i]) }, n);
+				at = n;
+			}
+			if (str.empty()) nfa[from].eps.push_back(to);
+		}
+
+		bool Dfa::_Repeat(Function<bool(uint32_t, uint32_t)> const& one, uint32_t min, int32_t max,
+			uint32_t from, uint32_t to)
+		{
+			uint32_t at = from;
+			for (uint32_t i = 0; i < min; i++)
+			{
+				uint32_t n = _New();
+				if (!one(at, n)) return false;
+				at = n;
+			}
+			if (-1 == max)
+			{
+				uint32_t loop = _New(), in = _New(), out = _New();
+				nfa[at].eps.push_back(loop);
+				nfa[loop].eps.push_back(to);
+				nfa[loop].eps.push_back(in);
+				nfa[out].eps.push_back(loop);
+				return one(in, out);
+			}
+			for (uint32_t i = min; i < (uint32_t)max; i++)
+			{
+				uint32_t n = _New();
+				nfa[at].eps.push_back(to);
+				if (!one(at, n)) return false;
+				at = n;
+			}
+			nfa[at].eps.push_back(to);
+			return true;
+		}
+
+		void Dfa::_Closure(Vector<uint32_t>& states) const
+		{
+			Vector<bool> seen(nfa.size());
+			Vector<uint32_t> todo(states);
+			states.clear();
+			while (!todo.empty())
+			{
+				uint32_t s = todo.back();
+				todo.pop_back();
+				if (seen[s]) continue;
+				seen[s] = true;
+				states.push_back(s);
+				todo.insert(todo.end(), nfa[s].eps.begin(), nfa[s].eps.end());
+			}
+			std::sort(states.begin(), states.end());
+		}
+
+		bool Dfa::Build(uint32_t limit)
+		{
+			// Split the characters where any charset starts or ends, then merge
+			// the pieces no charset tells apart into classes.
+			const CharT last = 0x7FFFFFFF;
+			Set<CharT> cuts{ 0 };
+			for (auto& set : sets)
+				for (auto& r : set.Ranges())
+				{
+					cuts.insert(r.from);
+					if (r.to < last) cuts.insert(r.to + 1);
+				}
+			bounds.assign(cuts.begin(), cuts.end());
+			boundClass.clear();
+			std::map<Vector<bool>, uint32_t> ids;
+			Vector<bool> member;		// By class, then set.
+			for (auto b : bounds)
+			{
+				Vector<bool> in;
+				for (auto& set : sets) in.push_back(set.Has(b));
+				auto i = ids.find(in);
+				if (i == ids.end())
+				{
+					i = ids.insert({ in, (uint32_t)ids.size() }).first;
+					member.insert(member.end(), in.begin(), in.end());
+				}
+				boundClass.push_back(i->second);
+			}
+			classes = (uint32_t)ids.size();
+			for (CharT c = 0; c < 0x80; c++)
+				ascii[c] = boundClass[std::upper_bound(bounds.begin(), bounds.end(), c) - bounds.begin() - 1];
+
+			// Subset construction, the start state is 0.
+			next.clear();
+			accept.clear();
+			std::map<Vector<uint32_t>, uint32_t> states;
+			Vector<Vector<uint32_t>> todo{ { 0 } };
+			_Closure(todo[0]);
+			states[todo[0]] = 0;
+			for (size_t i = 0; i < todo.size(); i++)
+			{
+				Vector<uint32_t> cur = todo[i];
+				uint32_t tag = Dead;
+				for (auto s : cur) tag = std::min(tag, nfa[s].tag);
+				accept.push_back(tag);
+				for (uint32_t c = 0; c < classes; c++)
+				{
+					Vector<uint32_t> move;
+					for (auto s : cur)
+						for (auto& edge : nfa[s].edges)
+							if (member[c * sets.size() + edge.first]) move.push_back(edge.second);
+					if (move.empty())
+					{
+						next.push_back(Dead);
+						continue;
+					}
+					_Closure(move);
+					auto at = states.find(move);
+					if (at == states.end())
+					{
+						if (todo.size() >= limit)
+						{
+							next.clear();
+							accept.clear();
+							return false;
+						}
+						at = states.insert({ move, (uint32_t)todo.size() }).first;
+						todo.push_back(move);
+					}
+					next.push_back(at->second);
+				}
+			}
+			return true;
+		}
+
+		// A subset construction that also notes whether a match of 'a' ended on
+		// the way, looking for a subset where 'b' matches after one did.
+		bool Dfa::Shadows(uint32_t a, uint32_t b, uint32_t limit) const
+		{
+			// A character of each class.
+			Vector<CharT> sample(classes);
+			for (size_t i = 0; i < bounds.size(); i++) sample[boundClass[i]] = bounds[i];
+			auto has = [this](Vector<uint32_t> const& states, uint32_t tag)
+			{
+				for (auto s : states)
+					if (tag == nfa[s].tag) return true;
+				return false;
+			};
+			using Step = std::pair<Vector<uint32_t>, bool>;
+			Vector<Step> todo{ { { 0 }, false } };
+			_Closure(todo[0].first);
+			todo[0].second = has(todo[0].first, a);
+			Set<Step> seen{ todo[0] };
+			for (size_t i = 0; i < todo.size(); i++)
+			{
+				Step cur = todo[i];
+				if (cur.second && has(cur.first, b)) return true;
+				for (uint32_t c = 0; c < classes; c++)
+				{
+					Step move{ {}, cur.second };
+					for (auto s : cur.first)
+						for (auto& edge : nfa[s].edges)
+							if (sets[edge.first].Has(sample[c])) move.first.push_back(edge.second);
+					if (move.first.empty()) continue;
+					_Closure(move.first);
+					move.second = move.second || has(move.first, a);
+					if (!seen.insert(move).second) continue;
+					if (todo.size() >= limit) return false;
+					todo.push_back(move);
+				}
+			}
+			return false;
+		}
+
+		uint32_t Dfa::Run(U32Itor& input, U32Itor const& end, U32Itor* stop) const
+		{
+			if (accept.empty()) return Dead;
+			U32Itor at = input, matched = input;
+			uint32_t state = 0, tag = accept[0];
+			while (at != end)
+			{
+				uint32_t n = next[state * classes + _Class(*at)];
+				if (Dead == n) break;
+				state = n;
+				++at;
+				if (Dead != accept[state])
+				{
+					tag = accept[state];
+					matched = at;
+				}
+			}
+			if (at == end) FailureTracker::ReachEnd();
+			if (stop) *stop = at;
+			if (Dead != tag) input = matched;
+			return tag;
+		}
+	}
+}
\ No newline at end of file
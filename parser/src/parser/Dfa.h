@@ -0,0 +1,122 @@
+#pragma once
+#include "parser/CharSet.h"
+namespace em
+{
+	namespace parser
+	{
+		// A deterministic automaton built from the regular parts of a grammar:
+		// literals, token sets without a boundary, charsets, spans, sequences,
+		// alternatives and repetitions.
+		// Actions and rules are looked through. Skippers, breakers, rules that
+		// reach themselves and other expressions are not regular here.
+		// Characters are grouped into classes that no charset tells apart, so
+		// a step is a class lookup and one table read.
+		struct Dfa
+		{
+			static const uint32_t Dead = (uint32_t)-1;
+
+			// Adds an expression whose matches report 'tag'. False if it is not
+			// regular, the automaton is then left as it was.
+			bool Add(ExprBase const* e, uint32_t tag);
+			// Builds the tables, false if it would take more than 'limit' states.
+			bool Build(uint32_t limit = 4096);
+			// Moves 'input' past the longest match and returns its tag, the lower
+			// one on a tie, or Dead leaving 'input' alone. 'stop' gets the first
+			// character no match could go on with.
+			uint32_t Run(U32Itor& input, U32Itor const& end, U32Itor* stop = nullptr) const;
+			// Whether some input that tag 'b' matches starts with, or is, a match
+			// of tag 'a', so a choice that tries 'a' first never gives it to 'b'.
+			// Call it after Build(); false if it takes more than 'limit' steps.
+			bool Shadows(uint32_t a, uint32_t b, uint32_t limit = 4096) const;
+			size_t States() const { return accept.size(); }
+			bool AcceptsEmpty() const { return !accept.empty() && Dead != accept[0]; }
+		private:
+			struct NfaState
+			{
+				Vector<uint32_t> eps;
+				Vector<std::pair<uint32_t, uint32_t>> edges;	// Index in 'sets', target.
+				uint32_t tag = Dead;
+			};
+			Vector<NfaState> nfa{ NfaState() };
+			Vector<CharSet> sets;
+
+			// Class intervals start at 'bounds'.
+			Vector<CharT> bounds;
+			Vector<uint32_t> boundClass;
+			uint32_t ascii[0x80];
+			uint32_t classes = 0;
+			Vector<uint32_t> next;		// By state, then class.
+			Vector<uint32_t> accept;
+
+			uint32_t _New();
+			void _Edge(uint32_t from, CharSet const& set, uint32_t to);
+			bool _Build(ExprBase const* e, uint32_t from, uint32_t to, Vector<ExprBase const*>& rules);
+			void _Chars(Vector<CharT> const& str, uint32_t from, uint32_t to);
+			bool _Repeat(Function<bool(uint32_t, uint32_t)> const& one, uint32_t min, int32_t max,
+				uint32_t from, uint32_t to);
+			void _Closure(Vector<uint32_t>& states) const;
+			uint32_t _Class(CharT c) const
+			{
+				if (c < 0x80) return ascii[c];
+				return boundClass[std::upper_bound(bounds.begin(), bounds.end(), c) - bounds.begin() - 1];
+			}
+		};
+
+		// A part without results compiled by Optimizer::Compile. It matches as
+		// 'source' does, in one pass.
+		struct DfaExpr : Expr<Void>
+		{
+			using Result = Void;
+			Ptr<Expr<Void>> source;
+			Ptr<Dfa> dfa;
+			DfaExpr(Ptr<Expr<Void>> const& e, Ptr<Dfa> const& d) : source(e), dfa(d) {}
+			// The source stays reachable for Analyzer and error messages.
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(source.get()); }
+			virtual bool AcceptsEmpty() const { return dfa->AcceptsEmpty(); }
+			virtual String Describe() const { return source->Describe(); }
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const&)
+			{
+				U32Itor stop = input;
+				if (Dfa::Dead != dfa->Run(input, end, &stop)) return Void();
+				FailureTracker::Fail(stop, this);
+				return null;
+			}
+		};
+
+		// Matches like its expression and yields the text matched, as a token:
+		// the skipper runs once before it and not inside. Results and actions
+		// inside are dropped, so a regular expression is matched by a Dfa.
+		template <typename Out>
+		struct CaptureExpr : Expr<Span>
+		{
+			using Result = Span;
+			Ptr<Expr<Out>> expr;
+			Ptr<Dfa> dfa;
+			CaptureExpr(Ptr<Expr<Out>> const& e) : expr(e) {}
+			virtual ExprKind Kind() const { return ExprKind::Capture; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual String Describe() const { return expr->Describe(); }
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				RunSkipper(s, input, end);
+				auto from = input.Base();
+				if (dfa)
+				{
+					U32Itor stop = input;
+					if (Dfa::Dead == dfa->Run(input, end, &stop))
+					{
+						FailureTracker::Fail(stop, this);
+						return null;
+					}
+				}
+				else if (!expr->Match(input, end, nullptr)) return null;
+				return Span{ from, input.Base() };
+			}
+			virtual void Optimize(Optimizer& o)
+			{
+				o.Rewrite(expr);
+				dfa = o.Regular(expr.get(), true);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -1,19 +1,234 @@
 #pragma once
+#include <cstring>
+
 #include "parser/Core.h"
 #include "parser/Iterator.h"
+#include "parser/Optimizer.h"
 namespace em
 {
 	namespace parser
 	{
 		template <typename Out> struct Rule;
+		struct CharSet;
+
+		enum class ExprKind
+		{
+			Other, Sequ, Expect, Chain, Alt, Rep, Fold, Ref, Action, Breaker, Skip,
+			Recover, Precedence, Capture, Literal, CharSet, SkipChar, Symbols, Span, Until
+		};
+
+		struct ExprBase
+		{
+			virtual ExprKind Kind() const { return ExprKind::Other; }
+			// The parts in match order. A Ref leads to the rule's expression,
+			// a SkipExpr lists its expression before its skipper.
+			virtual void Children(Vector<ExprBase const*>&) const {}
+			// Facts about the expression itself, not counting its parts, for
+			// Analyzer: whether it matches empty input, the characters it may
+			// start with and, for a repetition, its bounds.
+			virtual bool AcceptsEmpty() const { return false; }
+			virtual void FirstChars(CharSet&) const {}
+			virtual void Bounds(uint32_t& min, int32_t& max) const { min = max = 1; }
+			// What the expression expects to see, for error messages.
+			virtual String Describe() const { return String(); }
+			// Rewrites the parts, see Optimizer.
+			virtual void Optimize(Optimizer&) {}
+			virtual ~ExprBase() {};
+		};
+
+		// Collects the expressions failing at the farthest input position while
+		// a ParseWithReport runs on this thread. Terminals report themselves;
+		// other parses only pay a check per failed terminal.
+		struct FailureTracker
+		{
+			static thread_local FailureTracker* current;
+
+			static void Fail(U32Itor const& input, ExprBase const* e)
+			{
+				if (current) current->_Fail(input.Base(), Location{ input.Line(), input.Col() }, e);
+			}
+			// Called by a terminal that read up to the end of the input, matching
+			// or not. More input could have changed the parse then.
+			static void ReachEnd()
+			{
+				if (current) current->reachedEnd = true;
+			}
+			bool ReachedEnd() const { return reachedEnd; }
+			// Falls back to 'input' when nothing failed.
+			Farthest Result(U32Itor const& input) const;
+			bool Failed() const { return any; }
+			std::string::iterator At() const { return at; }
+			// Takes over the failures of a tracker that ran nested.
+			void Merge(FailureTracker const& other)
+			{
+				for (auto e : other.expected) _Fail(other.at, other.loc, e);
+				reachedEnd = reachedEnd || other.reachedEnd;
+			}
+
+			// Installs a tracker, or none, for the current thread.
+			struct Scope
+			{
+				FailureTracker* prev;
+				Scope(FailureTracker* t) : prev(current) { current = t; }
+				~Scope() { current = prev; }
+			};
+			// Stops recording failures in the current tracker for a while.
+			// Reaching the end is still recorded.
+			struct Pause
+			{
+				FailureTracker* tracker;
+				bool prev;
+				Pause() : tracker(current), prev(current && current->paused)
+				{
+					if (tracker) tracker->paused = true;
+				}
+				~Pause()
+				{
+					if (tracker) tracker->paused = prev;
+				}
+			};
+		private:
+			bool any = false, reachedEnd = false, paused = false;
+			std::string::iterator at;
+			Location loc{};
+			Vector<ExprBase const*> expected;
+			void _Fail(std::string::iterator const& pos, Location const& l, ExprBase const* e)
+			{
+				if (paused || (any && pos < at)) return;
+				if (!any || at < pos)
+				{
+					any = true;
+					at = pos;
+					loc = l;
+					expected.clear();
+				}
+				if (std::find(expected.begin(), expected.end(), e) == expected.end())
+					expected.push_back(e);
+			}
+		};
+
+		// Maps strings to ids in the order they are first seen.
+		struct Interner
+		{
+			TrieMap<uint32_t> map;
+			Vector<String> store;
+			uint32_t Intern(char const* str, size_t size)
+			{
+				auto i = map.find_ks(str, size);
+				if (i == map.end())
+				{
+					uint32_t ret = (uint32_t)store.size();
+					map.insert_ks(str, size, ret);
+					store.emplace_back(str, size);
+					return ret;
+				}
+				return *i;
+			}
+			void Clear()
+			{
+				map.clear();
+				store.clear();
+			}
+			// The ids the strings of 'other' get when interned here in order.
+			Vector<uint32_t> Ids(Interner const& other) const
+			{
+				Vector<uint32_t> ret;
+				uint32_t next = (uint32_t)store.size();
+				for (auto& str : other.store)
+				{
+					auto i = map.find_ks(str.data(), str.size());
+					ret.push_back(i == map.end() ? next++ : *i);
+				}
+				return ret;
+			}
+		};
+
+		// What a parse writes to: the stores behind StoreString and StoreId,
+		// and the errors recover_ moved past. A grammar is only read while it
+		// parses, so threads can share one grammar, each parsing with a
+		// context of its own.
+		struct ParseContext
+		{
+			Interner strings, ids;
+			// In input order.
+			Vector<ParseError> errors;
+			String& GetId(uint32_t const& idx) { return ids.store.at(idx); }
+			String& GetStr(uint32_t const& idx) { return strings.store.at(idx); }
+			void Clear()
+			{
+				strings.Clear();
+				ids.Clear();
+				errors.clear();
+				errorsAt.clear();
+			}
+			// Called by recover_ with where the input it skipped starts.
+			void Recovered(std::string::iterator const& from, ParseError const& e)
+			{
+				errors.push_back(e);
+				errorsAt.push_back(from);
+			}
+			// Drops the errors in input from 'at' on, which the parse went back
+			// over. Only a check when there are none.
+			static void Backtrack(std::string::iterator const& at)
+			{
+				if (current && !current->errorsAt.empty() && !(current->errorsAt.back() < at))
+					current->_Drop(at);
+			}
+			// Takes over the errors of a context that parsed the input after.
+			void TakeErrors(ParseContext const& other)
+			{
+				errors.insert(errors.end(), other.errors.begin(), other.errors.end());
+				errorsAt.insert(errorsAt.end(), other.errorsAt.begin(), other.errorsAt.end());
+			}
+
+			// The context actions store to, on this thread.
+			static thread_local ParseContext* current;
+			struct Scope
+			{
+				ParseContext* prev;
+				Scope(ParseContext* c) : prev(current) { current = c; }
+				~Scope() { current = prev; }
+			};
+		private:
+			Vector<std::string::iterator> errorsAt;
+			void _Drop(std::string::iterator const& at)
+			{
+				while (!errorsAt.empty() && !(errorsAt.back() < at))
+				{
+					errorsAt.pop_back();
+					errors.pop_back();
+				}
+			}
+		};
 
 		template <typename Out>
-		struct Expr
+		struct Expr : ExprBase
 		{
 			virtual Nullable<Out> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s) = 0;
+			// Parses without building the result or running actions, see Validate.
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return !Parse(input, end, s).IsNull();
+			}
+			// An equivalent replacement once the parts are optimized, if any.
+			virtual Ptr<Expr<Out>> Simplify(Optimizer&) { return nullptr; }
 			virtual ~Expr() {};
 		};
 
+		// Runs the skipper for as long as it matches. What the skipper fails on
+		// is not worth reporting, so tracking is paused meanwhile.
+		inline void RunSkipper(Ptr<Expr<Void>> const& s, U32Itor& input, U32Itor const& end)
+		{
+			if (!s) return;
+			if (!FailureTracker::current)
+			{
+				while (!s->Parse(input, end, nullptr).IsNull());
+				return;
+			}
+			FailureTracker::Pause pause;
+			while (!s->Parse(input, end, nullptr).IsNull());
+		}
+
 
 		template <typename Out1, typename Out2>
 		struct Sequ : Expr<typename MakeTuple<Out1, Out2>::type>
@@ -35,36 +250,168 @@ namespace em
 				}
 				return null;
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return first->Match(input, end, s) && second->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Sequ; }
+			virtual void Children(Vector<ExprBase const*>& out) const
+			{
+				out.push_back(first.get());
+				out.push_back(second.get());
+			}
+			virtual String Describe() const { return first->Describe(); }
+			virtual void Optimize(Optimizer& o)
+			{
+				o.Rewrite(first);
+				o.Rewrite(second);
+			}
+			virtual Ptr<Expr<Result>> Simplify(Optimizer& o)
+			{
+				return o.Sequence(first, second, this);
+			}
 		};
 		template <typename Out1, typename Out2>
 		using SequType = typename Sequ<Out1, Out2>::Result;
 
+		// A sequence after a cut: once the first part matched, the second one
+		// must match too, or a ParseError is thrown instead of backtracking.
+		template <typename Out1, typename Out2>
+		struct Expect : Sequ<Out1, Out2>
+		{
+			using Result = SequType<Out1, Out2>;
+			Expect(Ptr<Expr<Out1>> const& e1, Ptr<Expr<Out2>> const& e2)
+				: Sequ<Out1, Out2>(e1, e2) {}
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				Nullable<Out1> res1 = this->first->Parse(input, end, s);
+				if (res1.IsNull()) return null;
+				U32Itor at = input;
+				Nullable<Out2> res2 = this->second->Parse(input, end, s);
+				if (res2.IsNull()) _Throw(at, end, s);
+				return MakeTuple<Out1, Out2>()(res1.Get(), res2.Get());
+			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				if (!this->first->Match(input, end, s)) return false;
+				U32Itor at = input;
+				if (!this->second->Match(input, end, s)) _Throw(at, end, s);
+				return true;
+			}
+			virtual ExprKind Kind() const { return ExprKind::Expect; }
+			virtual Ptr<Expr<Result>> Simplify(Optimizer&) { return nullptr; }
+		private:
+			void _Throw(U32Itor at, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				RunSkipper(s, at, end);
+				throw ParseError(Location{ at.Line(), at.Col() },
+					this->second->Describe());
+			}
+		};
+
+		// A flattened sequence of parts without results, built by Optimizer.
+		struct Chain : Expr<Void>
+		{
+			using Result = Void;
+			Vector<Ptr<Expr<Void>>> parts;
+			Chain(Vector<Ptr<Expr<Void>>> const& p) : parts(p) {}
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				for (auto& p : parts)
+					if (p->Parse(input, end, s).IsNull()) return null;
+				return Void();
+			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				for (auto& p : parts)
+					if (!p->Match(input, end, s)) return false;
+				return true;
+			}
+			virtual ExprKind Kind() const { return ExprKind::Chain; }
+			virtual void Children(Vector<ExprBase const*>& out) const
+			{
+				for (auto& p : parts) out.push_back(p.get());
+			}
+			virtual String Describe() const { return parts[0]->Describe(); }
+			virtual void Optimize(Optimizer& o)
+			{
+				for (auto& p : parts) o.Rewrite(p);
+			}
+		};
+
 		template <typename Out>
 		struct Alt : Expr<Out>
 		{
 			using Result = Out;
-			Ptr<Expr<Out>> left;
-			Ptr<Expr<Out>> right;
+			// Tried in order. Built in pairs, Optimizer flattens nested ones.
+			Vector<Ptr<Expr<Out>>> alts;
 			Alt(Ptr<Expr<Out>> const& l, Ptr<Expr<Out>> const& r)
-				: left(l), right(r) {}
+				: alts{ l, r } {}
 			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
 			{
 				U32Itor save = input;
-				Nullable<Out> res1 = left->Parse(input, end, s);
-				if (res1.IsNull())
+				for (auto& a : alts)
 				{
+					Nullable<Out> res = a->Parse(input, end, s);
+					if (!res.IsNull()) return res.Get();
 					input = save;
-					Nullable<Out> res2 = right->Parse(input, end, s);
-					if (res2.IsNull())
-					{
-						return null;
-					}
-					return res2.Get();
+					ParseContext::Backtrack(save.Base());
+				}
+				return null;
+			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				U32Itor save = input;
+				for (auto& a : alts)
+				{
+					if (a->Match(input, end, s)) return true;
+					input = save;
+				}
+				return false;
+			}
+			virtual ExprKind Kind() const { return ExprKind::Alt; }
+			virtual void Children(Vector<ExprBase const*>& out) const
+			{
+				for (auto& a : alts) out.push_back(a.get());
+			}
+			virtual String Describe() const
+			{
+				String ret;
+				for (auto& a : alts)
+				{
+					String d = a->Describe();
+					if (d.empty()) return String();
+					ret += (ret.empty() ? "" : " or ") + d;
 				}
-				return res1.Get();
+				return ret;
+			}
+			virtual void Optimize(Optimizer& o)
+			{
+				for (auto& a : alts) o.Rewrite(a);
+			}
+			virtual Ptr<Expr<Out>> Simplify(Optimizer& o)
+			{
+				Vector<Ptr<Expr<Out>>> flat;
+				for (auto& a : alts)
+				{
+					auto alt = std::dynamic_pointer_cast<Alt<Out>>(a);
+					if (alt) flat.insert(flat.end(), alt->alts.begin(), alt->alts.end());
+					else flat.push_back(a);
+				}
+				o.Alternatives(flat);
+				if (1 == flat.size()) return flat[0];
+				alts = flat;
+				return nullptr;
 			}
 		};
 
+		// A bare CharSetExpr or SkipCharExpr, which Rep can scan in one go.
+		CharSet const* BareCharSet(Ptr<Expr<CharT>> const& e);
+		CharSet const* BareCharSet(Ptr<Expr<Void>> const& e);
+		uint32_t ScanCharSet(CharSet const& set, U32Itor& input, U32Itor const& end, uint32_t max, Vector<CharT>* out);
+		// An UntilExpr for '*char_()[literal]', which Rep can jump over in one go.
+		Ptr<Expr<Span>> BareUntil(Ptr<Expr<Void>> const& e);
+
 		template <int32_t Min, int32_t Max, typename Out>
 		struct Rep : Expr<Vector<Out>>
 		{
@@ -86,27 +433,111 @@ namespace em
 					return ret;
 				else return null;
 			}
+			// Counts instead of collecting.
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				uint32_t count{};
+				while ((Max == -1 || count < (uint32_t)Max) && expr->Match(input, end, s)) count++;
+				return count >= Min;
+			}
+			virtual ExprKind Kind() const { return ExprKind::Rep; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual void Bounds(uint32_t& min, int32_t& max) const { min = Min; max = Max; }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(expr); }
+		};
+		template <int32_t Min, int32_t Max>
+		struct Rep<Min, Max, CharT> : Expr<Vector<CharT>>
+		{
+			using Result = Vector<CharT>;
+			Ptr<Expr<CharT>> expr;
+			CharSet const* set;
+			Rep(Ptr<Expr<CharT>> const& e)
+				:expr(e), set(BareCharSet(e)) {}
+
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				Vector<CharT> ret;
+				if (set && !s)
+				{
+					if (ScanCharSet(*set, input, end, (uint32_t)Max, &ret) < (uint32_t)Max)
+						FailureTracker::Fail(input, expr.get());
+				}
+				else while (Max == -1 || ret.size() < Max)
+				{
+					Nullable<CharT> res = expr->Parse(input, end, s);
+					if (res.IsNull()) break;
+					else ret.push_back(res.Get());
+				}
+				if ((Max == -1 || ret.size() <= Max) && ret.size() >= Min)
+					return ret;
+				else return null;
+			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				uint32_t count{};
+				if (set && !s)
+				{
+					count = ScanCharSet(*set, input, end, (uint32_t)Max, nullptr);
+					if (count < (uint32_t)Max) FailureTracker::Fail(input, expr.get());
+				}
+				else while ((Max == -1 || count < (uint32_t)Max) && expr->Match(input, end, s)) count++;
+				return count >= Min;
+			}
+			virtual ExprKind Kind() const { return ExprKind::Rep; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual void Bounds(uint32_t& min, int32_t& max) const { min = Min; max = Max; }
+			virtual void Optimize(Optimizer& o)
+			{
+				o.Rewrite(expr);
+				set = BareCharSet(expr);
+			}
 		};
 		template <int32_t Min, int32_t Max>
 		struct Rep<Min, Max, Void> : Expr<Void>
 		{
 			using Result = Void;
 			Ptr<Expr<Void>> expr;
+			CharSet const* set;
+			Ptr<Expr<Span>> until;
 			Rep(Ptr<Expr<Void>> const& e)
-				:expr(e) {}
+				:expr(e), set(BareCharSet(e)),
+				until(Max == -1 && Min <= 1 ? BareUntil(e) : nullptr) {}
 
 			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				if (_Run(input, end, s, true)) return Void();
+				else return null;
+			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return _Run(input, end, s, false);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Rep; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual void Bounds(uint32_t& min, int32_t& max) const { min = Min; max = Max; }
+			virtual void Optimize(Optimizer& o)
+			{
+				o.Rewrite(expr);
+				set = BareCharSet(expr);
+				until = Max == -1 && Min <= 1 ? BareUntil(expr) : nullptr;
+			}
+		private:
+			// With 'parse' unset, the parts are matched only.
+			bool _Run(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s, bool parse)
 			{
 				uint32_t count{};
-				while (Max == -1 || count < Max)
+				if (set && !s)
 				{
-					Nullable<Void> res = expr->Parse(input, end, s);
-					if (res.IsNull()) break;
+					count = ScanCharSet(*set, input, end, (uint32_t)Max, nullptr);
+					if (count < (uint32_t)Max) FailureTracker::Fail(input, expr.get());
+				}
+				else if (until && !s) count = until->Parse(input, end, s).Get().Size() ? 1 : 0;
+				else while (Max == -1 || count < Max)
+				{
+					if (parse ? expr->Parse(input, end, s).IsNull() : !expr->Match(input, end, s)) break;
 					else count++;
 				}
-				if ((Max == -1 || count <= Max) && count >= Min)
-					return Void();
-				else return null;
+				return (Max == -1 || count <= Max) && count >= Min;
 			}
 		};
 		template <int32_t Min, int32_t Max, typename Out>
@@ -124,6 +555,24 @@ namespace em
 			{
 				return ref.expr->Parse(input, end, s);
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return ref.expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Ref; }
+			virtual void Children(Vector<ExprBase const*>& out) const
+			{
+				if (ref.expr) out.push_back(ref.expr.get());
+			}
+			virtual String Describe() const { return ref.name; }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(ref.expr); }
+			// Named rules stay, their names show up in error messages.
+			virtual Ptr<Expr<Result>> Simplify(Optimizer& o)
+			{
+				if (!ref.name.empty() || !ref.expr || o.Recursive(ref.expr.get()))
+					return nullptr;
+				return ref.expr;
+			}
 		};
 
 		template <typename In, typename Out>
@@ -141,6 +590,14 @@ namespace em
 					input.Line(), input.Col() });
 				return null;
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Action; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual String Describe() const { return expr->Describe(); }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(expr); }
 		};
 
 		template <typename In>
@@ -162,6 +619,14 @@ namespace em
 				}
 				return null;
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Action; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual String Describe() const { return expr->Describe(); }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(expr); }
 		};
 
 		template <typename In, typename Out>
@@ -178,6 +643,14 @@ namespace em
 				if (!res.IsNull()) return func(res.Get());
 				return null;
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Action; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual String Describe() const { return expr->Describe(); }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(expr); }
 		};
 		template <typename Out>
 		struct Cast<Void, Out> : Expr<Out>
@@ -193,6 +666,14 @@ namespace em
 				if (!res.IsNull()) return func();
 				return null;
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Action; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual String Describe() const { return expr->Describe(); }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(expr); }
 		};
 		template <typename In>
 		struct Cast<In, void> : Expr<Void>
@@ -212,6 +693,14 @@ namespace em
 				}
 				return null;
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Action; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual String Describe() const { return expr->Describe(); }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(expr); }
 		};
 		template<>
 		struct Cast<Void, void> : Expr<Void>
@@ -231,6 +720,14 @@ namespace em
 				}
 				return null;
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Action; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual String Describe() const { return expr->Describe(); }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(expr); }
 		};
 
 		template <typename Out>
@@ -245,9 +742,27 @@ namespace em
 			{
 				U32Itor save = input;
 				Nullable<Void> bk = breaker->Parse(save, end, s);
+				ParseContext::Backtrack(input.Base());
 				if (!bk.IsNull()) return null;
 				return expr->Parse(input, end, s);
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				U32Itor save = input;
+				if (breaker->Match(save, end, s)) return false;
+				return expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Breaker; }
+			virtual void Children(Vector<ExprBase const*>& out) const
+			{
+				out.push_back(expr.get());
+				out.push_back(breaker.get());
+			}
+			virtual void Optimize(Optimizer& o)
+			{
+				o.Rewrite(expr);
+				o.Rewrite(breaker);
+			}
 		};
 
 		template <typename Out>
@@ -266,30 +781,147 @@ namespace em
 			{
 				return expr->Parse(input, end, skip);
 			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const&)
+			{
+				return expr->Match(input, end, skip);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Skip; }
+			virtual void Children(Vector<ExprBase const*>& out) const
+			{
+				out.push_back(expr.get());
+				if (skip) out.push_back(skip.get());
+			}
+			virtual String Describe() const { return expr->Describe(); }
+			virtual void Optimize(Optimizer& o)
+			{
+				o.Rewrite(expr);
+				o.Rewrite(skip);
+			}
+			// The skipper is dropped when it is the one in use already, and
+			// so is an outer skipper overridden by an inner one.
+			virtual Ptr<Expr<Result>> Simplify(Optimizer& o)
+			{
+				if (ExprKind::Skip == expr->Kind() || o.SameSkipper(this, skip.get()))
+					return expr;
+				return nullptr;
+			}
 		};
 
-		template <typename Char>
-		struct TokenExpr : Expr<Void>
+		struct LiteralExpr : Expr<Void>
 		{
 			using Result = Void;
-			Vector<Char> str;
-			TokenExpr(Char const* s)
+			Vector<CharT> str;
+			// The literals this one was joined from by Optimize, in order. A
+			// mismatch is reported at the start of the piece it is in.
+			Vector<Ptr<LiteralExpr>> pieces;
+			// Fails if a character has no UTF-8 form.
+			bool Utf8(String& out) const;
+			virtual ExprKind Kind() const { return ExprKind::Literal; }
+			virtual bool AcceptsEmpty() const { return str.empty(); }
+			virtual void FirstChars(CharSet& out) const;
+			virtual String Describe() const
 			{
-				while (*s) str.push_back(*s++);
+				String text;
+				return Utf8(text) ? '"' + text + '"' : String();
 			}
 			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
 			{
-				while (s && !s->Parse(input, end, nullptr).IsNull());
+				RunSkipper(s, input, end);
 				auto save = input;
-				for (auto& ch : str)
+				for (size_t i = 0; i < str.size(); i++)
 				{
-					if (save == end) return null;
-					if (ch != *save) return null;
+					if (save == end || str[i] != *save)
+					{
+						if (save == end) FailureTracker::ReachEnd();
+						_Fail(input, i);
+						return null;
+					}
 					save++;
 				}
 				input = save;
 				return Void();
 			}
+		private:
+			void _Fail(U32Itor at, size_t i) const
+			{
+				ExprBase const* e = this;
+				for (auto& p : pieces)
+				{
+					if (i < p->str.size())
+					{
+						e = p.get();
+						break;
+					}
+					i -= p->str.size();
+					for (size_t n = 0; n < p->str.size(); n++) at++;
+				}
+				FailureTracker::Fail(at, e);
+			}
+		};
+
+		// Matches everything up to a terminator, which is not consumed, or up to
+		// the end of the input. The terminator is found with a byte search.
+		struct UntilExpr : Expr<Span>
+		{
+			using Result = Span;
+			String term;
+			UntilExpr(String const& t) : term(t) {}
+			virtual ExprKind Kind() const { return ExprKind::Until; }
+			virtual bool AcceptsEmpty() const { return true; }
+			virtual void FirstChars(CharSet& out) const;
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				RunSkipper(s, input, end);
+				auto from = input.Base(), to = end.Base(), at = to;
+				if (term.empty()) at = from;
+				else if (from != to)
+				{
+					char const* first = &*from;
+					char const* last = first + (to - from);
+					for (char const* p = first;
+						(p = (char const*)std::memchr(p, term[0], last - p)); p++)
+						if (_Match(p + 1, last))
+						{
+							at = from + (p - first);
+							break;
+						}
+				}
+				// U32Itor reads a '\r' together with the character after it.
+				if (at != to) while (at != from && '\r' == *(at - 1)) --at;
+				else if (!term.empty()) FailureTracker::ReachEnd();
+				input.Advance(at);
+				return Span{ from, at };
+			}
+		private:
+			bool _Match(char const* p, char const* last) const
+			{
+				for (size_t i = 1; i < term.size(); p++)
+				{
+					if (p == last) return false;
+					if ('\r' == *p) continue;
+					if (term[i++] != *p) return false;
+				}
+				return true;
+			}
+		};
+
+		template <typename Char>
+		struct TokenExpr : LiteralExpr
+		{
+			TokenExpr(Char const* s)
+			{
+				while (*s) str.push_back((CharT)*s++);
+			}
+		};
+		// Char strings are UTF-8, as Symbols keys are.
+		template <>
+		struct TokenExpr<char> : LiteralExpr
+		{
+			TokenExpr(char const* s)
+			{
+				String text(s);
+				for (U32Itor i(text.begin()), end(text.end()); i != end; ++i) str.push_back(*i);
+			}
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+#include "parser/CharSet.h"
+namespace em
+{
+	namespace parser
+	{
+		// A repetition handing each element to 'step' as it is parsed instead
+		// of collecting a Vector. With 'sep', elements are separated by it and
+		// a separator without an element after it is not consumed.
+		template <typename Acc, typename Out>
+		struct FoldExpr : Expr<Acc>
+		{
+			using Result = Acc;
+			using Step = Function<void(Acc&, Out const&)>;
+			Ptr<Expr<Out>> expr;
+			Ptr<Expr<Void>> sep;
+			Acc init;
+			Step step;
+			uint32_t min;
+			int32_t max;
+			FoldExpr(Ptr<Expr<Out>> const& e, Ptr<Expr<Void>> const& p, Acc const& i,
+				Step const& f, uint32_t mn, int32_t mx)
+				: expr(e), sep(p), init(i), step(f), min(mn), max(mx) {}
+
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				Acc ret = init;
+				uint32_t count = 0;
+				while (-1 == max || count < (uint32_t)max)
+				{
+					U32Itor save = input;
+					if (count && sep && sep->Parse(input, end, s).IsNull()) break;
+					Nullable<Out> res = expr->Parse(input, end, s);
+					if (res.IsNull())
+					{
+						if (count && sep)
+						{
+							input = save;
+							ParseContext::Backtrack(save.Base());
+						}
+						break;
+					}
+					step(ret, res.Get());
+					count++;
+				}
+				if (count >= min) return ret;
+				else return null;
+			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				uint32_t count = 0;
+				while (-1 == max || count < (uint32_t)max)
+				{
+					U32Itor save = input;
+					if (count && sep && !sep->Match(input, end, s)) break;
+					if (!expr->Match(input, end, s))
+					{
+						if (count && sep) input = save;
+						break;
+					}
+					count++;
+				}
+				return count >= min;
+			}
+			// Not a Rep: 'step' must run, so it is never compiled to an automaton.
+			virtual ExprKind Kind() const { return ExprKind::Fold; }
+			virtual void Children(Vector<ExprBase const*>& out) const
+			{
+				out.push_back(expr.get());
+				if (sep) out.push_back(sep.get());
+			}
+			virtual void Bounds(uint32_t& mn, int32_t& mx) const { mn = min; mx = max; }
+			virtual void Optimize(Optimizer& o)
+			{
+				o.Rewrite(expr);
+				if (sep) o.Rewrite(sep);
+			}
+		};
+
+		template <typename Acc, typename Out>
+		inline Node<Acc> fold_(Node<Out> const& n, Acc const& init,
+			typename FoldExpr<Acc, Out>::Step const& step, uint32_t min = 0, int32_t max = -1)
+		{
+			return Node<Acc>{
+				std::make_shared<FoldExpr<Acc, Out>>(n.expr, nullptr, init, step, min, max)
+			};
+		}
+		template <typename Acc, typename Out>
+		inline Node<Acc> fold_(Rule<Out>& r, Acc const& init,
+			typename FoldExpr<Acc, WarpVoid<Out>>::Step const& step, uint32_t min = 0, int32_t max = -1)
+		{
+			return Node<Acc>{
+				std::make_shared<FoldExpr<Acc, WarpVoid<Out>>>(r.Alias(), nullptr, init, step, min, max)
+			};
+		}
+		template <typename Acc>
+		inline Node<Acc> fold_(CharSet const& set, Acc const& init,
+			typename FoldExpr<Acc, CharT>::Step const& step, uint32_t min = 0, int32_t max = -1)
+		{
+			return Node<Acc>{
+				std::make_shared<FoldExpr<Acc, CharT>>(std::make_shared<CharSetExpr>(set),
+					nullptr, init, step, min, max)
+			};
+		}
+
+		template <typename Acc, typename Out>
+		inline Node<Acc> sep_fold_(Node<Out> const& n, Node<Void> const& sep, Acc const& init,
+			typename FoldExpr<Acc, Out>::Step const& step, uint32_t min = 0, int32_t max = -1)
+		{
+			return Node<Acc>{
+				std::make_shared<FoldExpr<Acc, Out>>(n.expr, sep.expr, init, step, min, max)
+			};
+		}
+		template <typename Acc, typename Out>
+		inline Node<Acc> sep_fold_(Rule<Out>& r, Node<Void> const& sep, Acc const& init,
+			typename FoldExpr<Acc, WarpVoid<Out>>::Step const& step, uint32_t min = 0, int32_t max = -1)
+		{
+			return Node<Acc>{
+				std::make_shared<FoldExpr<Acc, WarpVoid<Out>>>(r.Alias(), sep.expr, init, step, min, max)
+			};
+		}
+	}
+}
\ No newline at end of file
@@ -1,88 +1,99 @@
 #pragma once
-#include <cuchar>
-#include <locale>
 #include "parser/Rule.h"
+#include "parser/Analyzer.h"
 namespace em
 {
 	namespace parser
 	{
-
-		inline const char* ToUtf8(char32_t const* str, size_t size = -1)
-		{
-			static Vector<char> res;
-			std::locale::global(std::locale(".utf8"));
-			std::mbstate_t state{};
-			res.clear();
-			for (int i = 0; i < size && *str; i++, str++)
-			{
-				char out[MB_LEN_MAX]{};
-				std::size_t rc = std::c32rtomb(out, *str, &state);
-				for (int i = 0; i < rc; i++) res.push_back(out[i]);
-			}
-			std::locale::global(std::locale(""));
-			res.push_back(0);
-			return res.data();
-		}
-
 		template <typename Out>
 		struct GrammarBase
 		{
 		private:
 			Rule<Out>& startNode;
-			Ptr<TrieMap<uint32_t>>
-				strings = std::make_shared<TrieMap<uint32_t>>(),
-				ids = std::make_shared<TrieMap<uint32_t>>();
-			Ptr<Vector<String>>
-				strings_store = std::make_shared<Vector<String>>(),
-				ids_store = std::make_shared<Vector<String>>();
+			// For the calls that are given no context.
+			Ptr<ParseContext> context = std::make_shared<ParseContext>();
 
-			uint32_t _StoredString(Vector<CharT> const& v)
+			ParseContext& _Context()
 			{
-				String str(ToUtf8(v.data(), v.size()));
-				auto i = strings->find(str.data());
-				if (i == strings->end())
+				return ParseContext::current ? *ParseContext::current : *context;
+			}
+			// Encodes on the stack when the text is short enough, so most values
+			// are looked up without allocating.
+			static uint32_t _Encoded(Vector<CharT> const& v, Interner& to)
+			{
+				char small[256];
+				String large;
+				char* out = small;
+				if (v.size() * 4 > sizeof(small))
 				{
-					uint32_t ret = (uint32_t)strings_store->size();
-					strings->insert(str.data(),
-						strings_store->size());
-					strings_store->push_back(str);
-					return ret;
+					large.resize(v.size() * 4);
+					out = &large[0];
 				}
-				return *i;
+				return to.Intern(out, EncodeUtf8(v.data(), v.size(), out));
+			}
+			uint32_t _StoredString(Vector<CharT> const& v)
+			{
+				return _Encoded(v, _Context().strings);
 			}
 			uint32_t _StoredId(Vector<CharT> const& v)
 			{
-				String str(ToUtf8(v.data(), v.size()));
-				auto i = ids->find(str.data());
-				if (i == ids->end())
-				{
-					uint32_t ret = (uint32_t)ids_store->size();
-					ids->insert(str.data(),
-						ids_store->size());
-					ids_store->push_back(str);
-					return ret;
-				}
-				return *i;
+				return _Encoded(v, _Context().ids);
+			}
+			// The bytes are looked up where they are, without decoding them.
+			uint32_t _StoredSpanId(Span const& s)
+			{
+				return _Context().ids.Intern(&*s.from, s.Size());
 			}
 		protected:
 			using base_type = GrammarBase<Out>;
 			const Function<uint32_t(Vector<CharT> const&)>
 				StoreString = std::bind(&base_type::_StoredString, this, std::placeholders::_1),
 				StoreId = std::bind(&base_type::_StoredId, this, std::placeholders::_1);
+			const Function<uint32_t(Span const&)>
+				StoreSpanId = std::bind(&base_type::_StoredSpanId, this, std::placeholders::_1);
 
 		public:
 			GrammarBase(Rule<Out>& start) : startNode(start) {}
 			virtual ~GrammarBase() {}
 			virtual Nullable<WarpVoid<Out>> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
 			{
-				strings->clear();
-				ids->clear();
-				ids_store->clear();
-				strings_store->clear();
+				return Parse(input, end, s, *context);
+			}
+			// Stores to 'ctx', which is cleared first, instead of the grammar.
+			Nullable<WarpVoid<Out>> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s,
+				ParseContext& ctx)
+			{
+				ctx.Clear();
+				ParseContext::Scope scope(&ctx);
 				return startNode.expr->Parse(input, end, s);
 			}
-			String& GetId(uint32_t const& idx) { return ids_store->at(idx); }
-			String& GetStr(uint32_t const& idx) { return strings_store->at(idx); }
+			// Actions are not run, so the string and id stores stay as they are.
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return startNode.expr->Match(input, end, s);
+			}
+			// Rewrites the rules reachable from the start rule into an equivalent,
+			// smaller graph. Call it once all rules are assigned, before the
+			// grammar parses on any thread; rules it shares with another grammar
+			// are rewritten for that one too.
+			OptimizeStats Optimize()
+			{
+				OptimizeStats ret{ Optimizer::Count(startNode.expr.get()), 0 };
+				Optimizer().Run(startNode.expr);
+				ret.after = Optimizer::Count(startNode.expr.get());
+				return ret;
+			}
+			// Reports unassigned rules, repetitions that may loop forever, left
+			// recursion and ordered choices whose alternatives start alike.
+			Vector<GrammarIssue> Analyze() const
+			{
+				return Analyzer(startNode.expr.get()).Issues(
+					startNode.name.empty() ? String("start") : startNode.name);
+			}
+			// Where the calls that are given no context store to.
+			ParseContext& Context() { return *context; }
+			String& GetId(uint32_t const& idx) { return context->GetId(idx); }
+			String& GetStr(uint32_t const& idx) { return context->GetStr(idx); }
 		};
 	}
 }
\ No newline at end of file
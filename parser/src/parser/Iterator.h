@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <iterator>
 
 #include "parser/Core.h"
@@ -8,6 +9,60 @@ namespace em
 	{
 		struct CharSet;
 		extern const CharSet Control_Char, Full_Width;
+
+		// Writes the UTF-8 form of 'c', 1 to 4 bytes, and returns how many.
+		// Surrogates and values past U+10FFFF are written as U+FFFD.
+		inline size_t EncodeUtf8(CharT c, char* out)
+		{
+			if (c < 0x80)
+			{
+				out[0] = (char)c;
+				return 1;
+			}
+			if (c < 0x800)
+			{
+				out[0] = (char)(0xC0 | (c >> 6));
+				out[1] = (char)(0x80 | (c & 0x3F));
+				return 2;
+			}
+			if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) c = 0xFFFD;
+			if (c < 0x10000)
+			{
+				out[0] = (char)(0xE0 | (c >> 12));
+				out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+				out[2] = (char)(0x80 | (c & 0x3F));
+				return 3;
+			}
+			out[0] = (char)(0xF0 | (c >> 18));
+			out[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+			out[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+			out[3] = (char)(0x80 | (c & 0x3F));
+			return 4;
+		}
+		// Encodes 'size' characters, or up to a 0, into 'out', which must have
+		// room for 4 bytes a character. Returns the bytes written. Nothing is
+		// allocated and no locale is involved, so it is safe on any thread.
+		inline size_t EncodeUtf8(CharT const* str, size_t size, char* out)
+		{
+			char* at = out;
+			size_t i = 0;
+			while (i < size && str[i])
+			{
+				// Runs of ASCII are copied a byte a character.
+				while (i < size && str[i] && str[i] < 0x80) *at++ = (char)str[i++];
+				if (i < size && str[i]) at += EncodeUtf8(str[i++], at);
+			}
+			return at - out;
+		}
+		// For building grammars, where a String is wanted anyway.
+		inline String ToUtf8(CharT const* str, size_t size = -1)
+		{
+			size_t n = 0;
+			while (n < size && str[n]) n++;
+			String ret(n * 4, '\0');
+			ret.resize(EncodeUtf8(str, n, &ret[0]));
+			return ret;
+		}
 		template <typename BaseIter>
 		struct U8toU32Iterator : std::iterator<std::input_iterator_tag, CharT>
 		{
@@ -19,6 +74,12 @@ namespace em
 			U8toU32Iterator(U const& i)
 				: _up(i), _next(i),
 				_line(1), _col(1), _pos(0) {}
+			// Starts at 'i' as if the line, column and byte position had been
+			// reached before it, to go on counting over input that came in parts.
+			template <typename U, typename = CheckedType<IsSame<U, BaseIter>>>
+			U8toU32Iterator(U const& i, uint32_t line, uint32_t col, uint32_t pos)
+				: _up(i), _next(i),
+				_line(line), _col(col), _pos(pos) {}
 			U8toU32Iterator(U8toU32Iterator& i)
 				: _up(i._up), _next(i._next), _buf(i._buf),
 				_line(i._line), _col(i._col), _pos(i._pos) {}
@@ -57,6 +118,99 @@ namespace em
 			uint32_t Line() const { return _line; }
 			uint32_t Col() const { return _col; }
 			uint32_t Pos() const { return _pos; }
+			BaseIter Base() const { return _up; }
+
+			// Moves over at most 'max' characters accepted by 'pred'. Plain ASCII
+			// bytes are tested and counted in place without going through Parse().
+			template <typename Pred>
+			uint32_t Scan(U8toU32Iterator const& end, uint32_t max, Pred const& pred)
+			{
+				uint32_t count = 0;
+				while (count < max)
+				{
+					if (_next == _up && _up != end._up
+						&& 0x80 > (uint8_t)*_up && '\r' != *_up)
+					{
+						_buf = (uint8_t)*_up;
+						if (!pred(_buf)) break;
+						++_up;
+						++_pos;
+						if (_buf == '\t') _col += 4;
+						else if (_buf == '\n') { _line++; _col = 1; }
+						else if (_buf >= 0x20 && _buf != 0x7F) _col++;
+						_next = _up;
+					}
+					else
+					{
+						if (*this == end || !pred(**this)) break;
+						++*this;
+					}
+					count++;
+				}
+				return count;
+			}
+			// Like Scan(), but runs of plain ASCII bytes go to 'run' first, which
+			// returns how many of the 'n' bytes at 'p' it accepts, as 'pred' would.
+			// Only other characters are tested one at a time with 'pred'.
+			template <typename Run, typename Pred>
+			uint32_t Scan(U8toU32Iterator const& end, uint32_t max, Run const& run, Pred const& pred)
+			{
+				uint32_t count = 0;
+				while (count < max)
+				{
+					if (_next == _up && _up != end._up)
+					{
+						char const* p = &*_up;
+						size_t n = std::min<size_t>(end._up - _up, max - count);
+						char const* at = p;
+						for (char const* to = p + run(p, n); at != to; at++)
+						{
+							if (*at >= 0x20 && *at != 0x7F) _col++;
+							else if ('\t' == *at) _col += 4;
+							else if ('\n' == *at) { _line++; _col = 1; }
+							else if ('\r' == *at) break;
+						}
+						size_t k = at - p;
+						if (k)
+						{
+							_buf = (uint8_t)p[k - 1];
+							_up += k;
+							_next = _up;
+							_pos += (uint32_t)k;
+							count += (uint32_t)k;
+						}
+						if (k == n) continue;
+						if (0x80 > (uint8_t)p[k] && '\r' != p[k]) break;
+					}
+					if (*this == end || !pred(**this)) break;
+					++*this;
+					count++;
+				}
+				return count;
+			}
+			// Jumps to 'to', a later character boundary. Lines are counted in bulk
+			// and only the last line is decoded to get the column.
+			void Advance(BaseIter const& to)
+			{
+				if (_up == to) return;
+				if (_next != _up) ++*this;
+				uint32_t pos = _pos + (uint32_t)std::distance(_up, to);
+				BaseIter from = _up;
+				if (uint32_t lines = (uint32_t)std::count(_up, to, '\n'))
+				{
+					using Rev = std::reverse_iterator<BaseIter>;
+					from = std::find(Rev(to), Rev(_up), '\n').base();
+					_line += lines;
+					_col = 1;
+				}
+				while (from != to)
+				{
+					from = ParseAChar(from);
+					CalcPos();
+				}
+				_pos = pos;
+				_up = _next = to;
+			}
 		private:
 			inline void SkipBOM()
 			{
@@ -71,9 +225,8 @@ namespace em
 					_ASSERT_EXPR(false, "Invalid utf-8 string.");
 				}
 			}
-			inline BaseIter ParseAChar()
+			inline BaseIter ParseAChar(BaseIter ret)
 			{
-				BaseIter ret = _up;
 				bool failed = false;
 				if (0x7F >= (uint8_t)*ret)							// 1 byte
 				{
@@ -126,8 +279,8 @@ namespace em
 			}
 			inline BaseIter Parse()
 			{
-				BaseIter ret = ParseAChar();
-				while (_buf == '\r') ret = ParseAChar();
+				BaseIter ret = ParseAChar(_up);
+				while (_buf == '\r') ret = ParseAChar(ret);
 				return ret;
 			}
 			inline void CalcPos()
@@ -143,5 +296,13 @@ namespace em
 		};
 
 		using U32Itor = U8toU32Iterator<std::string::iterator>;
+
+		// The UTF-8 bytes between two positions of the input, without a copy.
+		struct Span
+		{
+			std::string::iterator from, to;
+			size_t Size() const { return to - from; }
+			String Str() const { return String(from, to); }
+		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "parser/Lexer.h"
+namespace em
+{
+	namespace parser
+	{
+		thread_local TokenStream const* TokenStream::current = nullptr;
+
+		void TokenStream::Push(uint32_t kind, uint32_t offset, uint32_t length)
+		{
+			char buf[4];
+			text.append(buf, EncodeUtf8(Char(kind), buf));
+			tokens.push_back(Token{ kind, offset, length });
+		}
+
+		Location TokenStream::At(uint32_t index) const
+		{
+			std::string::iterator from = source;
+			U32Itor at(from);
+			if (index < tokens.size()) at.Advance(source + tokens[index].offset);
+			else if (!tokens.empty()) at.Advance(source + tokens.back().offset + tokens.back().length);
+			return Location{ at.Line(), at.Col() };
+		}
+
+		bool Lexer::Build(uint32_t limit)
+		{
+			dfa = Dfa();
+			if (badKind) return false;
+			for (uint32_t i = 0; i < defs.size(); i++)
+				if (!dfa.Add(defs[i].get(), i)) return false;
+			return dfa.Build(limit);
+		}
+
+		bool Lexer::Tokenize(U32Itor& input, U32Itor const& end, TokenStream& out) const
+		{
+			out.source = input.Base();
+			out.tokens.clear();
+			out.text.clear();
+			while (input != end)
+			{
+				auto from = input.Base();
+				uint32_t tag = dfa.Run(input, end);
+				if (Dfa::Dead == tag) return false;
+				// An empty match would not move on.
+				if (input.Base() == from) return false;
+				if (Dfa::Dead == kinds[tag]) continue;
+				out.Push(kinds[tag], (uint32_t)(from - out.source), (uint32_t)(input.Base() - from));
+			}
+			return true;
+		}
+	}
+}
\ No newline at end of file
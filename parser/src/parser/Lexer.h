@@ -0,0 +1,136 @@
+#pragma once
+#include "parser/Dfa.h"
+namespace em
+{
+	namespace parser
+	{
+		struct Token
+		{
+			uint32_t kind;
+			uint32_t offset, length;	// In bytes, from TokenStream::source.
+		};
+
+		// Tokens cut from a text by a Lexer. A grammar runs on 'text', one
+		// private use character per token, and matches tokens with token_().
+		struct TokenStream
+		{
+			std::string::iterator source;
+			Vector<Token> tokens;
+			String text;
+
+			// Kinds up to MaxKind fit in the private use area. Characters from
+			// U+F000 are left out: their first byte, 0xEF, starts a BOM to U32Itor.
+			static const uint32_t MaxKind = 0xFFF;
+			static CharT Char(uint32_t kind) { return 0xE000 + kind; }
+			// Each token takes three bytes of 'text'.
+			static const uint32_t Width = 3;
+
+			void Push(uint32_t kind, uint32_t offset, uint32_t length);
+			Span Text(uint32_t index) const
+			{
+				auto from = source + tokens[index].offset;
+				return Span{ from, from + tokens[index].length };
+			}
+			// Where a token starts in the source, for error messages.
+			Location At(uint32_t index) const;
+			// Where a location in 'text' is in the source. Parse() on tokens
+			// counts columns in tokens from the first, so column c is token c - 1.
+			Location At(Location const& inText) const { return At(inText.col - 1); }
+
+			// The stream a grammar runs on, on this thread.
+			static thread_local TokenStream const* current;
+			struct Scope
+			{
+				TokenStream const* prev;
+				Scope(TokenStream const* t) : prev(current) { current = t; }
+				~Scope() { current = prev; }
+			};
+		};
+
+		// Compiles token definitions and a skipper into one Dfa and cuts text
+		// into tokens in a single pass. The longest match wins, then the
+		// definition added first.
+		struct Lexer
+		{
+			template <typename Out>
+			Lexer& Add(uint32_t kind, Node<Out> const& def)
+			{
+				_Check(kind);
+				defs.push_back(def.expr);
+				kinds.push_back(kind);
+				return *this;
+			}
+			template <typename Out>
+			Lexer& Add(uint32_t kind, Rule<Out>& def)
+			{
+				_Check(kind);
+				defs.push_back(def.Alias());
+				kinds.push_back(kind);
+				return *this;
+			}
+			// Matches of 'def' are dropped.
+			template <typename Out>
+			Lexer& Skip(Node<Out> const& def)
+			{
+				return Add(Dfa::Dead, def);
+			}
+			template <typename Out>
+			Lexer& Skip(Rule<Out>& def)
+			{
+				return Add(Dfa::Dead, def);
+			}
+			// False when a definition is not regular, a kind is above
+			// TokenStream::MaxKind or the automaton gets too big.
+			bool Build(uint32_t limit = 4096);
+			// False at the first text no definition matches, 'input' is left there.
+			bool Tokenize(U32Itor& input, U32Itor const& end, TokenStream& out) const;
+		private:
+			Vector<Ptr<ExprBase>> defs;
+			Vector<uint32_t> kinds;
+			Dfa dfa;
+			bool badKind = false;
+			void _Check(uint32_t kind)
+			{
+				if (kind > TokenStream::MaxKind && Dfa::Dead != kind) badKind = true;
+			}
+		};
+
+		// Matches a token of the kind and returns its text from the source.
+		struct TokenKindExpr : Expr<Span>
+		{
+			using Result = Span;
+			uint32_t kind;
+			String name;
+			TokenKindExpr(uint32_t k, String const& n) : kind(k), name(n) {}
+			virtual void FirstChars(CharSet& out) const
+			{
+				out = out | CharSet{ CharRange(TokenStream::Char(kind)) };
+			}
+			virtual String Describe() const { return name; }
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				RunSkipper(s, input, end);
+				TokenStream const* t = TokenStream::current;
+				if (!t || input == end || *input != TokenStream::Char(kind))
+				{
+					FailureTracker::Fail(input, this);
+					return null;
+				}
+				uint32_t index = (uint32_t)(input.Base() - t->text.begin()) / TokenStream::Width;
+				++input;
+				return t->Text(index);
+			}
+		};
+
+		inline Node<Span> token_text_(uint32_t kind, String const& name = String())
+		{
+			return Node<Span>{ std::make_shared<TokenKindExpr>(kind, name) };
+		}
+		// Like token_text_() but without a result, as tk_() is for characters.
+		inline Node<Void> token_(uint32_t kind, String const& name = String())
+		{
+			return Node<Void>{ std::make_shared<Cast<Span, void>>(
+				std::make_shared<TokenKindExpr>(kind, name), [](Span const&) {}) };
+		}
+	}
+}
\ No newline at end of file
@@ -10,6 +10,18 @@ namespace em
 		struct CharSetExpr;
 		struct ClearSkip {};
 		extern const ClearSkip NoSkip;
+		struct CutMark {};
+		extern const CutMark cut_;
+
+		template <typename Out>
+		inline Ptr<Expr<Out>> MakeAlt(Ptr<Expr<Out>> const& l, Ptr<Expr<Out>> const& r)
+		{
+			return std::make_shared<Alt<Out>>(l, r);
+		}
+		// Alternatives of plain literals are fused into one ordered trie, and
+		// of bare char sets into one set.
+		Ptr<Expr<Void>> MakeAlt(Ptr<Expr<Void>> const& l, Ptr<Expr<Void>> const& r);
+		Ptr<Expr<CharT>> MakeAlt(Ptr<Expr<CharT>> const& l, Ptr<Expr<CharT>> const& r);
 
 		template <typename T>
 		using WarpLambdaReturn = WarpVoid<LambdaReturn<T>>;
@@ -46,11 +58,13 @@ namespace em
 		{
 			using Result = Out;
 			Ptr<Expr<Out>> expr;
-			Node(Node const& node) :expr(node.expr) {}
-			Node(Node&& node) noexcept :expr(std::move(node.expr)) {}
-			Node(Ptr<Expr<Out>> const& e) :expr(e) {}
-			Node& operator=(Node const& node) { expr = node.expr; return *this; }
-			Node& operator=(Node&& node) noexcept { expr = std::move(node.expr); return *this; }
+			// Set after a cut, the following parts of the sequence are expected.
+			bool cut = false;
+			Node(Node const& node) :expr(node.expr), cut(node.cut) {}
+			Node(Node&& node) noexcept :expr(std::move(node.expr)), cut(node.cut) {}
+			Node(Ptr<Expr<Out>> const& e, bool c = false) :expr(e), cut(c) {}
+			Node& operator=(Node const& node) { expr = node.expr; cut = node.cut; return *this; }
+			Node& operator=(Node&& node) noexcept { expr = std::move(node.expr); cut = node.cut; return *this; }
 
 			template <typename F>
 			CastNodeType<F, Out> operator[](F const& f) const
@@ -119,13 +133,32 @@ namespace em
 			}
 
 			template <typename COut>
-			Node<SequType<Out, COut>>
-				operator>(Node<COut> const& other) const
+			Node<SequType<Out, COut>> Then(Ptr<Expr<COut>> const& e) const
 			{
+				if (cut) return Node<SequType<Out, COut>>{
+					std::make_shared<Expect<Out, COut>>(expr, e), true
+				};
 				return Node<SequType<Out, COut>>{
-					std::make_shared<Sequ<Out, COut>>(expr, other.expr)
+					std::make_shared<Sequ<Out, COut>>(expr, e)
 				};
 			}
+			Node<Out> operator>(CutMark const&) const
+			{
+				return Node<Out>{ expr, true };
+			}
+			// 'a >= b' is short for 'a > cut_ > b'.
+			template <typename T>
+			auto operator>=(T&& other) const
+				-> decltype(std::declval<Node<Out>>() > std::forward<T>(other))
+			{
+				return Node<Out>{ expr, true } > std::forward<T>(other);
+			}
+			template <typename COut>
+			Node<SequType<Out, COut>>
+				operator>(Node<COut> const& other) const
+			{
+				return Then(other.expr);
+			}
 			Node<Out> operator[](Node<Void> const& other) const
 			{
 				return Node<Out>{
@@ -136,33 +169,22 @@ namespace em
 			ValidCharReturn<Char, Node<SequType<Out, Void>>>
 				operator>(Char const* other) const
 			{
-				return Node<SequType<Out, Void>>{
-					std::make_shared<Sequ<Out, Void>>(
-						expr, std::make_shared<TokenExpr<Char>>(other))
-				};
+				return Then<Void>(std::make_shared<TokenExpr<Char>>(other));
 			}
 			Node<SequType<Out, CharT>> operator>(CharSet const& cset) const
 			{
-				return Node<SequType<Out, CharT>>{
-					std::make_shared<Sequ<Out, CharT>>(
-						expr, std::make_shared<CharSetExpr>(cset))
-				};
+				return Then<CharT>(std::make_shared<CharSetExpr>(cset));
 			}
 			template <typename COut>
 			Node<SequType<Out, WarpVoid<COut>>>
 				operator>(Rule<COut>& other) const
 			{
-				return Node<SequType<Out, WarpVoid<COut>>>{
-					std::make_shared<Sequ<Out, WarpVoid<COut>>>(
-						expr, std::make_shared<Ref<COut>>(other))
-				};
+				return Then<WarpVoid<COut>>(std::make_shared<Ref<COut>>(other));
 			}
 
 			Node<Out> operator|(Node<Out> const& other) const
 			{
-				return Node<Out>{
-					std::make_shared<Alt<Out>>(expr, other.expr)
-				};
+				return Node<Out>{ MakeAlt(expr, other.expr) };
 			}
 
 		};
@@ -187,12 +209,29 @@ namespace em
 			};
 		}
 		template <typename Char>
+		ValidCharReturn<Char, Node<Void>>
+			operator>(Char const* left, CutMark const&)
+		{
+			return Node<Void>{ std::make_shared<TokenExpr<Char>>(left), true };
+		}
+		template <typename Char, typename Out>
+		ValidCharReturn<Char, Node<SequType<Void, Out>>>
+			operator>=(Char const* left, Node<Out> const& right)
+		{
+			return left > cut_ > right;
+		}
+		template <typename Char, typename Out>
+		ValidCharReturn<Char, Node<SequType<Void, WarpVoid<Out>>>>
+			operator>=(Char const* left, Rule<Out>& right)
+		{
+			return left > cut_ > right;
+		}
+		template <typename Char>
 		ValidCharReturn<Char, Node<Void>>
 			operator|(Char const* left, Node<Void> const& right)
 		{
 			return Node<Void>{
-				std::make_shared<Alt<Void>>(
-					std::make_shared<TokenExpr<Char>>(left), right.expr)
+				MakeAlt(std::make_shared<TokenExpr<Char>>(left), right.expr)
 			};
 		}
 		template <typename Char, typename F>
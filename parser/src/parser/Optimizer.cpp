@@ -0,0 +1,380 @@
+#include "parser/Parser.h"
+namespace em
+{
+	namespace parser
+	{
+		namespace
+		{
+			// Whether the expression always matches: a repetition that may run
+			// no times, or a sequence of such.
+			bool _Total(ExprBase const* e, Vector<ExprBase const*>& rules)
+			{
+				Vector<ExprBase const*> children;
+				e->Children(children);
+				switch (e->Kind())
+				{
+				case ExprKind::Rep:
+				{
+					uint32_t min;
+					int32_t max;
+					e->Bounds(min, max);
+					return 0 == min;
+				}
+				case ExprKind::Sequ:
+				case ExprKind::Chain:
+					for (auto c : children)
+						if (!_Total(c, rules)) return false;
+					return true;
+				case ExprKind::Ref:
+				{
+					if (children.empty() || std::find(rules.begin(), rules.end(), e) != rules.end())
+						return false;
+					rules.push_back(e);
+					bool ret = _Total(children[0], rules);
+					rules.pop_back();
+					return ret;
+				}
+				case ExprKind::Action:
+				case ExprKind::Skip:
+					return 1 == children.size() && _Total(children[0], rules);
+				default:
+					return false;
+				}
+			}
+			// Whether a failed match leaves the input where it was. A sequence
+			// that fails halfway stays there when interpreted, and so does a
+			// repetition or option around it, while an automaton backs off to
+			// the longest match; the two agree only on such expressions.
+			bool _Atomic(ExprBase const* e, Vector<ExprBase const*>& rules)
+			{
+				Vector<ExprBase const*> children;
+				e->Children(children);
+				switch (e->Kind())
+				{
+				case ExprKind::Literal:
+				case ExprKind::CharSet:
+				case ExprKind::SkipChar:
+				case ExprKind::Span:
+				case ExprKind::Symbols:
+				case ExprKind::Alt:
+					return true;
+				case ExprKind::Sequ:
+				case ExprKind::Chain:
+					// Parts after the first must not fail.
+					for (size_t i = 1; i < children.size(); i++)
+						if (!_Total(children[i], rules)) return false;
+					return _Atomic(children[0], rules);
+				case ExprKind::Rep:
+				{
+					uint32_t min;
+					int32_t max;
+					e->Bounds(min, max);
+					// Only the first element can fail the repetition.
+					return 0 == min || (1 == min && _Atomic(children[0], rules));
+				}
+				case ExprKind::Ref:
+				{
+					if (children.empty() || std::find(rules.begin(), rules.end(), e) != rules.end())
+						return false;
+					rules.push_back(e);
+					bool ret = _Atomic(children[0], rules);
+					rules.pop_back();
+					return ret;
+				}
+				case ExprKind::Action:
+				case ExprKind::Skip:
+					return 1 == children.size() && _Atomic(children[0], rules);
+				default:
+					return false;
+				}
+			}
+
+			// Whether ordered choice and greedy repetition match what the longest
+			// match would: every choice and every exit is decided by the next
+			// character, given the characters that may follow the expression.
+			bool _Deterministic(Analyzer const& a, ExprBase const* e, CharSet const& follow,
+				bool withActions, Vector<ExprBase const*>& rules)
+			{
+				Vector<ExprBase const*> children;
+				e->Children(children);
+				auto det = [&](ExprBase const* c, CharSet const& f)
+				{
+					return _Deterministic(a, c, f, withActions, rules);
+				};
+				switch (e->Kind())
+				{
+				case ExprKind::Literal:
+				case ExprKind::CharSet:
+				case ExprKind::SkipChar:
+					return true;
+				case ExprKind::Span:
+				{
+					auto span = static_cast<SpanExpr const*>(e);
+					return span->min == span->max || !span->set.Intersects(follow);
+				}
+				case ExprKind::Symbols:
+				{
+					// The automaton takes the longest key, as the expression does
+					// unless a shorter key added earlier wins, and as long as
+					// nothing that follows can go on where the shorter key ends.
+					auto sym = dynamic_cast<SymbolsBase const*>(e);
+					Vector<String> keys = sym->Keys();
+					for (size_t i = 0; i < keys.size(); i++)
+						for (size_t j = 0; j < keys.size(); j++)
+						{
+							if (keys[j].size() <= keys[i].size() || keys[j].compare(0, keys[i].size(), keys[i]))
+								continue;
+							if (MatchMode::Ordered == sym->Mode() && i < j) return false;
+							if (follow.Has(*U32Itor(keys[j].begin() + keys[i].size()))) return false;
+						}
+					return true;
+				}
+				case ExprKind::Sequ:
+				case ExprKind::Chain:
+				{
+					CharSet after = follow;
+					for (size_t i = children.size(); i-- > 0;)
+					{
+						if (!det(children[i], after)) return false;
+						after = a.IsNullable(children[i]) ? a.First(children[i]) | after : a.First(children[i]);
+					}
+					return true;
+				}
+				case ExprKind::Alt:
+				{
+					// Only the last alternative may match empty input.
+					CharSet seen("");
+					for (size_t i = 0; i < children.size(); i++)
+					{
+						CharSet first = a.First(children[i]);
+						if (first.Intersects(seen) || !det(children[i], follow)) return false;
+						seen = seen | first;
+						if (a.IsNullable(children[i]) && i + 1 < children.size()) return false;
+					}
+					return !a.IsNullable(children.back()) || !seen.Intersects(follow);
+				}
+				case ExprKind::Rep:
+				{
+					uint32_t min;
+					int32_t max;
+					e->Bounds(min, max);
+					ExprBase const* elem = children[0];
+					ExprBase const* sep = children.size() > 1 ? children[1] : nullptr;
+					if (a.IsNullable(elem) || (sep && a.IsNullable(sep))) return false;
+					// An element or separator failing halfway ends the repetition
+					// there when interpreted.
+					if (!_Atomic(elem, rules) || (sep && !_Atomic(sep, rules))) return false;
+					CharSet next = a.First(sep ? sep : elem);
+					if ((-1 == max || (uint32_t)max > min) && next.Intersects(follow)) return false;
+					if (sep && 0 == min && a.First(elem).Intersects(follow)) return false;
+					return det(elem, next | follow) && (!sep || det(sep, a.First(elem)));
+				}
+				case ExprKind::Ref:
+				{
+					if (children.empty() || std::find(rules.begin(), rules.end(), e) != rules.end())
+						return false;
+					rules.push_back(e);
+					bool ret = det(children[0], follow);
+					rules.pop_back();
+					return ret;
+				}
+				case ExprKind::Action:
+					return withActions && det(children[0], follow);
+				case ExprKind::Skip:
+					return 1 == children.size() && det(children[0], follow);
+				default:
+					return false;
+				}
+			}
+		}
+
+		bool Optimizer::Context::operator<(Context const& other) const
+		{
+			if (known != other.known) return known < other.known;
+			return std::less<ExprBase const*>()(skip, other.skip);
+		}
+
+		// Walks the graph once to find the skipper each expression runs with.
+		// The start rule may be called with any skipper.
+		void Optimizer::_Contexts(ExprBase const* root)
+		{
+			using At = std::pair<ExprBase const*, Context>;
+			Set<At> seen;
+			Vector<At> todo{ At{ root, Context{ false, nullptr } } };
+			Vector<ExprBase const*> children;
+			while (!todo.empty())
+			{
+				At at = todo.back();
+				todo.pop_back();
+				if (!at.first || !seen.insert(at).second) continue;
+				auto i = contexts.find(at.first);
+				if (i == contexts.end()) contexts.insert(at);
+				else if (!at.second.known || i->second.skip != at.second.skip)
+					i->second.known = false;
+
+				children.clear();
+				at.first->Children(children);
+				if (ExprKind::Capture == at.first->Kind())
+					todo.push_back(At{ children[0], Context{ true, nullptr } });
+				else if (ExprKind::Skip == at.first->Kind())
+				{
+					// Skippers themselves run without a skipper.
+					ExprBase const* skip = children.size() > 1 ? children[1] : nullptr;
+					todo.push_back(At{ children[0], Context{ true, skip } });
+					todo.push_back(At{ skip, Context{ true, nullptr } });
+				}
+				else for (auto c : children) todo.push_back(At{ c, at.second });
+			}
+		}
+
+		bool Optimizer::NoSkipper(ExprBase const* e) const
+		{
+			return SameSkipper(e, nullptr);
+		}
+		bool Optimizer::SameSkipper(ExprBase const* e, ExprBase const* skip) const
+		{
+			auto i = contexts.find(e);
+			if (i == contexts.end() || !i->second.known) return false;
+			if (i->second.skip == skip) return true;
+			auto r = replaced.find(i->second.skip);
+			return r != replaced.end() && r->second.get() == skip;
+		}
+
+		bool Optimizer::Recursive(ExprBase const* e)
+		{
+			auto i = recursive.find(e);
+			if (i != recursive.end()) return i->second;
+			Set<ExprBase const*> seen;
+			Vector<ExprBase const*> todo;
+			e->Children(todo);
+			bool ret = false;
+			while (!todo.empty() && !ret)
+			{
+				auto at = todo.back();
+				todo.pop_back();
+				if (at == e) ret = true;
+				else if (seen.insert(at).second) at->Children(todo);
+			}
+			return recursive[e] = ret;
+		}
+
+		size_t Optimizer::Count(ExprBase const* root)
+		{
+			Set<ExprBase const*> seen;
+			Vector<ExprBase const*> todo{ root };
+			while (!todo.empty())
+			{
+				auto at = todo.back();
+				todo.pop_back();
+				if (at && seen.insert(at).second) at->Children(todo);
+			}
+			return seen.size();
+		}
+
+		Ptr<Dfa> Optimizer::Regular(ExprBase const* e, bool withActions)
+		{
+			auto dfa = std::make_shared<Dfa>();
+			if (!dfa->Add(e, 0)) return nullptr;
+			Analyzer a(e);
+			Vector<ExprBase const*> rules;
+			if (!_Atomic(e, rules) || !_Deterministic(a, e, CharSet(""), withActions, rules)) return nullptr;
+			if (!dfa->Build(256)) return nullptr;
+			return dfa;
+		}
+
+		Ptr<Expr<Void>> Optimizer::Compile(Ptr<Expr<Void>> const& e)
+		{
+			// Terminals, and repetitions of them, are scanned directly already.
+			Vector<ExprBase const*> children;
+			e->Children(children);
+			switch (e->Kind())
+			{
+			case ExprKind::Sequ:
+			case ExprKind::Chain:
+			case ExprKind::Alt:
+				break;
+			case ExprKind::Rep:
+			{
+				Vector<ExprBase const*> parts;
+				children[0]->Children(parts);
+				if (children.size() < 2 && parts.empty()) return nullptr;
+				break;
+			}
+			default:
+				return nullptr;
+			}
+			if (!NoSkipper(e.get())) return nullptr;
+			auto dfa = Regular(e.get());
+			if (!dfa) return nullptr;
+			return std::make_shared<DfaExpr>(e, dfa);
+		}
+
+		Ptr<Expr<Void>> Optimizer::Sequence(Ptr<Expr<Void>> const& first,
+			Ptr<Expr<Void>> const& second, ExprBase const* self)
+		{
+			Vector<Ptr<Expr<Void>>> parts;
+			for (auto& e : { first, second })
+			{
+				auto chain = std::dynamic_pointer_cast<Chain>(e);
+				if (chain) parts.insert(parts.end(), chain->parts.begin(), chain->parts.end());
+				else parts.push_back(e);
+			}
+			if (NoSkipper(self))
+			{
+				Vector<Ptr<Expr<Void>>> joined;
+				for (auto& p : parts)
+				{
+					auto lit = std::dynamic_pointer_cast<LiteralExpr>(p);
+					auto last = joined.empty() ? nullptr
+						: std::dynamic_pointer_cast<LiteralExpr>(joined.back());
+					if (lit && last)
+					{
+						auto both = std::make_shared<LiteralExpr>();
+						for (auto& l : { last, lit })
+						{
+							both->str.insert(both->str.end(), l->str.begin(), l->str.end());
+							if (l->pieces.empty()) both->pieces.push_back(l);
+							else both->pieces.insert(both->pieces.end(), l->pieces.begin(), l->pieces.end());
+						}
+						joined.back() = both;
+					}
+					else joined.push_back(p);
+				}
+				parts.swap(joined);
+			}
+			if (1 == parts.size()) return parts[0];
+			return std::make_shared<Chain>(parts);
+		}
+
+		void Optimizer::Alternatives(Vector<Ptr<Expr<CharT>>>& alts)
+		{
+			Vector<Ptr<Expr<CharT>>> joined;
+			for (auto& a : alts)
+			{
+				auto fused = joined.empty() ? nullptr : MakeAlt(joined.back(), a);
+				if (fused && ExprKind::Alt != fused->Kind()) joined.back() = fused;
+				else joined.push_back(a);
+			}
+			alts.swap(joined);
+		}
+		void Optimizer::Alternatives(Vector<Ptr<Expr<Void>>>& alts)
+		{
+			Vector<Ptr<Expr<Void>>> joined;
+			for (auto& a : alts)
+			{
+				if (!joined.empty())
+				{
+					auto& last = joined.back();
+					auto fused = MakeAlt(last, a);
+					if (ExprKind::Alt != fused->Kind())
+					{
+						last = fused;
+						continue;
+					}
+				}
+				joined.push_back(a);
+			}
+			alts.swap(joined);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include <map>
+
+#include "parser/Core.h"
+namespace em
+{
+	namespace parser
+	{
+		struct ExprBase;
+		template <typename Out> struct Expr;
+		struct Dfa;
+
+		struct OptimizeStats
+		{
+			size_t before, after;	// Expressions reachable from the start rule.
+		};
+
+		// Rewrites an expression graph in place into an equivalent, smaller one.
+		// Every expression rewrites its parts through Rewrite() and may then hand
+		// back a simpler replacement with the same result type. Nodes shared
+		// with other graphs, such as rules used by another grammar, change too,
+		// and nothing may parse with the graph while it runs.
+		struct Optimizer
+		{
+			template <typename T>
+			void Run(Ptr<Expr<T>>& root)
+			{
+				_Contexts(root.get());
+				Rewrite(root);
+			}
+			template <typename T>
+			void Rewrite(Ptr<Expr<T>>& e)
+			{
+				if (!e) return;
+				auto r = replaced.find(e.get());
+				if (r != replaced.end())
+				{
+					e = std::static_pointer_cast<Expr<T>>(r->second);
+					return;
+				}
+				if (!done.insert(e.get()).second) return;
+				// Keep every node seen alive, their addresses are used as keys.
+				keep.push_back(e);
+				if (auto d = Compile(e))
+				{
+					replaced[e.get()] = d;
+					done.insert(d.get());
+					keep.push_back(d);
+					e = d;
+					return;
+				}
+				e->Optimize(*this);
+				if (auto s = e->Simplify(*this))
+				{
+					replaced[e.get()] = s;
+					done.insert(s.get());
+					keep.push_back(s);
+					e = s;
+				}
+			}
+
+			// Whether the expression always runs without a skipper.
+			bool NoSkipper(ExprBase const* e) const;
+			// Whether the expression always runs with the given skipper.
+			bool SameSkipper(ExprBase const* e, ExprBase const* skip) const;
+			// Whether the expression can reach itself through rules.
+			bool Recursive(ExprBase const* e);
+			static size_t Count(ExprBase const* root);
+			// An automaton matching as the expression does. The expression must be
+			// regular and free of actions, unless 'withActions' lets them be left
+			// out. Every choice and every repetition exit must be decided by the
+			// next character, so the longest match is the match, and no part
+			// that fails halfway may be left where it failed, as a repetition
+			// or the expression itself would be.
+			Ptr<Dfa> Regular(ExprBase const* e, bool withActions = false);
+
+			template <typename Out>
+			Ptr<Expr<Out>> Compile(Ptr<Expr<Out>> const&) { return nullptr; }
+			// Replaces parts without results that run without a skipper by a
+			// DfaExpr, if they are Regular. Tried before the parts are rewritten,
+			// so the largest such part is compiled.
+			Ptr<Expr<Void>> Compile(Ptr<Expr<Void>> const& e);
+
+			template <typename Out1, typename Out2>
+			Ptr<Expr<typename MakeTuple<Out1, Out2>::type>> Sequence(
+				Ptr<Expr<Out1>> const&, Ptr<Expr<Out2>> const&, ExprBase const*)
+			{
+				return nullptr;
+			}
+			// Flattens parts without results into a Chain, joining neighbouring
+			// literals where no skipper can run between them. A joined literal
+			// keeps its pieces to report a mismatch where a piece starts.
+			Ptr<Expr<Void>> Sequence(Ptr<Expr<Void>> const& first,
+				Ptr<Expr<Void>> const& second, ExprBase const* self);
+
+			template <typename Out>
+			void Alternatives(Vector<Ptr<Expr<Out>>>&) {}
+			// Joins neighbouring char sets, and literals into a trie.
+			void Alternatives(Vector<Ptr<Expr<CharT>>>& alts);
+			void Alternatives(Vector<Ptr<Expr<Void>>>& alts);
+		private:
+			// The skipper an expression runs with, if it is always the same.
+			struct Context
+			{
+				bool known;
+				ExprBase const* skip;
+				bool operator<(Context const& other) const;
+			};
+			std::map<ExprBase const*, Context> contexts;
+			Set<ExprBase const*> done;
+			std::map<ExprBase const*, Ptr<ExprBase>> replaced;
+			std::map<ExprBase const*, bool> recursive;
+			Vector<Ptr<ExprBase>> keep;
+			void _Contexts(ExprBase const* root);
+		};
+	}
+}
\ No newline at end of file
@@ -5,11 +5,45 @@ namespace em
 	namespace parser
 	{
 		const ClearSkip NoSkip{};
-		namespace p
+		const CutMark cut_{};
+		thread_local FailureTracker* FailureTracker::current = nullptr;
+		thread_local ParseContext* ParseContext::current = nullptr;
+
+		Farthest FailureTracker::Result(U32Itor const& input) const
+		{
+			Farthest ret;
+			if (!any)
+			{
+				ret.loc = Location{ input.Line(), input.Col() };
+				return ret;
+			}
+			ret.loc = loc;
+			Set<String> names;
+			for (auto e : expected)
+			{
+				String name = e->Describe();
+				if (!name.empty()) names.insert(name);
+			}
+			ret.expected.assign(names.begin(), names.end());
+			return ret;
+		}
+
+		bool LiteralExpr::Utf8(String& out) const
+		{
+			for (auto& ch : str)
+				if (0 == ch || ch > 0x10FFFF || (ch >= 0xD800 && ch <= 0xDFFF))
+					return false;
+			out.resize(str.size() * 4);
+			out.resize(EncodeUtf8(str.data(), str.size(), &out[0]));
+			return true;
+		}
+		void LiteralExpr::FirstChars(CharSet& out) const
+		{
+			if (!str.empty()) out = out | CharSet{ CharRange(str[0]) };
+		}
+		void UntilExpr::FirstChars(CharSet& out) const
 		{
-			TrieMap<Node<Void>> tokens;
-			TrieMap<Node<Void>> skips;
-			TrieMap<Node<CharT>> chars;
+			out = CharSet();
 		}
 	}
 }
\ No newline at end of file
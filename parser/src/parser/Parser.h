@@ -1,144 +1,168 @@
 #pragma once
 #include "parser/GrammarBase.h"
 #include "parser/CharSet.h"
+#include "parser/Symbols.h"
+#include "parser/Recover.h"
+#include "parser/Precedence.h"
+#include "parser/Fold.h"
+#include "parser/Lexer.h"
 namespace em
 {
 	namespace parser
 	{
-		namespace p
+		// Each call makes a node of its own, owned by the rules that use it, so
+		// grammars share no state and can be built on any thread at once.
+		template <typename Char>
+		inline ValidCharReturn<Char, Node<Void>> tk_(Char const* str)
 		{
-			extern TrieMap<Node<Void>> tokens;
-			extern TrieMap<Node<Void>> skips;
-			extern TrieMap<Node<CharT>> chars;
+			return Node<Void>{ std::make_shared<TokenExpr<Char>>(str) };
+		}
+		template <typename Char>
+		inline ValidCharReturn<Char, Node<Void>> char_(Char const* str)
+		{
+			return Node<Void>{ std::make_shared<SkipCharExpr>(CharSet(str)) };
+		}
+		inline Node<Void> char_()
+		{
+			return Node<Void>{ std::make_shared<SkipCharExpr>(CharSet()) };
+		}
+		template <typename Char>
+		inline ValidCharReturn<Char, Node<CharT>> set_(Char const* str)
+		{
+			return Node<CharT>{ std::make_shared<CharSetExpr>(CharSet(str)) };
+		}
+		inline Node<CharT> set_()
+		{
+			return Node<CharT>{ std::make_shared<CharSetExpr>(CharSet()) };
+		}
 
-			template <typename Ret, typename Char>
-			inline Ret& _get_from_map(
-				TrieMap<Ret>& map, char const* str, Ret(*func)(Char const*), Char const* arg)
-			{
-				auto i = map.find(str);
-				if (i == map.end())
-				{
-					auto p = map.insert(str, func(arg));
-					return *p.first;
-				}
-				return *i;
-			}
-			template <typename Ret>
-			inline Ret& _get_from_map(
-				TrieMap<Ret>& map, Ret(*func)())
-			{
-				auto i = map.find("");
-				if (i == map.end())
-				{
-					auto p = map.insert("", func());
-					return *p.first;
-				}
-				return *i;
-			}
-			template <typename Char>
-			inline Node<Void> makeToken(Char const* str)
-			{
-				return Node<Void>{
-					std::make_shared<TokenExpr<Char>>(str)
-				};
-			}
-			template <typename Char>
-			inline Node<Void> skip_a_char_(Char const* str)
-			{
-				return Node<Void>{
-					std::make_shared<SkipCharExpr>(CharSet(str))
-				};
-			}
-			inline Node<Void> skip_a_char_()
-			{
-				return Node<Void>{
-					std::make_shared<SkipCharExpr>(CharSet())
-				};
-			}
+		inline Node<Span> span_(CharSet const& set, uint32_t min = 0, int32_t max = -1)
+		{
+			return Node<Span>{
+				std::make_shared<SpanExpr>(set, min, (uint32_t)max)
+			};
+		}
 
-			template <typename Char>
-			inline Node<CharT> char_from_set_(Char const* str)
-			{
-				return Node<CharT>{
-					std::make_shared<CharSetExpr>(CharSet(str))
-				};
-			}
-			inline Node<CharT> char_from_set_()
-			{
-				return Node<CharT>{
-					std::make_shared<CharSetExpr>(CharSet())
-				};
-			}
+		inline Node<Span> ident_(CharSet const& start = XID_Start, CharSet const& cont = XID_Continue)
+		{
+			return Node<Span>{ std::make_shared<IdentExpr>(start, cont) };
 		}
 
-		inline Node<Void>& tk_(char const* str)
+		template <typename Out>
+		inline Node<Span> capture_(Node<Out> const& n)
 		{
-			using F = Node<Void>(*)(char const*);
-			return p::_get_from_map(p::tokens, str,
-				static_cast<F>(p::makeToken<char>),
-				str);
+			return Node<Span>{ std::make_shared<CaptureExpr<Out>>(n.expr) };
 		}
-		inline Node<Void>& tk_(char32_t const* str)
+		template <typename Out>
+		inline Node<Span> capture_(Rule<Out>& r)
 		{
-			char const* utf8 = ToUtf8(str);
-			using F = Node<Void>(*)(char32_t const*);
-			return p::_get_from_map(p::tokens, utf8,
-				static_cast<F>(p::makeToken<char32_t>),
-				str);
+			return Node<Span>{ std::make_shared<CaptureExpr<WarpVoid<Out>>>(r.Alias()) };
 		}
-		inline Node<Void>& char_(char32_t const* str)
+
+		inline Node<Span> until_(char const* term)
 		{
-			using F = Node<Void>(*)(char32_t const*);
-			char const* utf8 = ToUtf8(str);
-			return p::_get_from_map(p::skips, utf8,
-				static_cast<F>(p::skip_a_char_<char32_t>),
-				str);
+			return Node<Span>{ std::make_shared<UntilExpr>(term) };
 		}
-		inline Node<Void>& char_(char const* str)
+		inline Node<Span> until_(char32_t const* term)
 		{
-			using F = Node<Void>(*)(char const*);
-			return p::_get_from_map(p::skips, str,
-				static_cast<F>(p::skip_a_char_<char>),
-				str);
+			return Node<Span>{ std::make_shared<UntilExpr>(ToUtf8(term)) };
 		}
-		inline Node<Void>& char_()
+
+		template <typename Out>
+		inline Nullable<WarpVoid<Out>> Parse(U32Itor& input, U32Itor const& end, GrammarBase<Out>& g)
 		{
-			return p::_get_from_map(p::skips, p::skip_a_char_);
+			return g.Parse(input, end, nullptr);
 		}
-		inline Node<CharT>& set_(char32_t const* str)
+		// Values are stored to 'ctx' instead of the grammar, so threads can
+		// share a grammar as long as each parses with a context of its own.
+		// The errors recover_ moved past are in ctx.errors after, and in
+		// g.Context().errors for the call above.
+		template <typename Out>
+		inline Nullable<WarpVoid<Out>> Parse(U32Itor& input, U32Itor const& end, GrammarBase<Out>& g,
+			ParseContext& ctx)
 		{
-			using F = Node<CharT>(*)(char32_t const*);
-			char const* utf8 = ToUtf8(str);
-			return p::_get_from_map(p::chars, utf8,
-				static_cast<F>(p::char_from_set_<char32_t>),
-				str);
+			return g.Parse(input, end, nullptr, ctx);
 		}
-		inline Node<CharT>& set_(char const* str)
+		inline void _ToSource(TokenStream const& tokens, Vector<ParseError>& errors)
 		{
-			using F = Node<CharT>(*)(char const*);
-			return p::_get_from_map(p::chars, str,
-				static_cast<F>(p::char_from_set_<char>),
-				str);
+			for (auto& e : errors) e = ParseError(tokens.At(e.loc), e.expected);
 		}
-		inline Node<CharT>& set_()
+		// Runs the grammar on tokens instead of characters, starting at token
+		// 'index' and moving it past the match. Tokens are matched by token_().
+		// Locations in a ParseError and in g.Context().errors are in the source.
+		template <typename Out>
+		inline Nullable<WarpVoid<Out>> Parse(TokenStream& tokens, uint32_t& index, GrammarBase<Out>& g)
 		{
-			return p::_get_from_map(p::chars, p::char_from_set_);
+			TokenStream::Scope scope(&tokens);
+			U32Itor input(tokens.text.begin() + index * TokenStream::Width, 1, index + 1, index * TokenStream::Width),
+				end(tokens.text.end());
+			Nullable<WarpVoid<Out>> ret;
+			try { ret = g.Parse(input, end, nullptr); }
+			catch (ParseError const& e)
+			{
+				_ToSource(tokens, g.Context().errors);
+				throw ParseError(tokens.At(e.loc), e.expected);
+			}
+			_ToSource(tokens, g.Context().errors);
+			index = (uint32_t)(input.Base() - tokens.text.begin()) / TokenStream::Width;
+			return ret;
+		}
+		// Checks the input like Parse() but builds no results and runs no
+		// actions. Repetitions count instead of collecting. 'input' is moved
+		// past the match; a ParseError after a cut gives false. recover_ does
+		// not skip malformed input here, it fails like its rule.
+		template <typename Out>
+		inline bool Validate(U32Itor& input, U32Itor const& end, GrammarBase<Out>& g)
+		{
+			try { return g.Match(input, end, nullptr); }
+			catch (ParseError const&) { return false; }
 		}
 
 		template <typename Out>
-		inline Nullable<WarpVoid<Out>> Parse(U32Itor& input, U32Itor const& end, GrammarBase<Out>& g)
+		struct ParseReport
 		{
-			return g.Parse(input, end, nullptr);
+			Nullable<WarpVoid<Out>> value;
+			// Where the parse got farthest, the place to report when 'value' is
+			// null or the input was not consumed to the end.
+			Farthest farthest;
+			// Errors recover_ moved past. 'value' is then a partial result.
+			Vector<ParseError> errors;
+		};
+		template <typename Out, typename F>
+		inline ParseReport<Out> _Report(U32Itor& input, ParseContext& ctx, F const& parse)
+		{
+			FailureTracker tracker;
+			FailureTracker::Scope scope(&tracker);
+			ParseReport<Out> ret;
+			ret.value = parse();
+			ret.farthest = tracker.Result(input);
+			ret.errors = ctx.errors;
+			return ret;
+		}
+		// Parses like Parse() while tracking the farthest failure in the same pass.
+		template <typename Out>
+		inline ParseReport<Out> ParseWithReport(U32Itor& input, U32Itor const& end, GrammarBase<Out>& g)
+		{
+			return _Report<Out>(input, g.Context(), [&] { return g.Parse(input, end, nullptr); });
 		}
-		inline void Clear()
+		template <typename Out>
+		inline ParseReport<Out> ParseWithReport(U32Itor& input, U32Itor const& end, GrammarBase<Out>& g,
+			ParseContext& ctx)
 		{
-			p::tokens.clear();
+			return _Report<Out>(input, ctx, [&] { return g.Parse(input, end, nullptr, ctx); });
 		}
-		inline Vector<String> Tokens()
+		// Like Parse() on tokens, with the farthest failure in the source.
+		template <typename Out>
+		inline ParseReport<Out> ParseWithReport(TokenStream& tokens, uint32_t& index, GrammarBase<Out>& g)
 		{
-			Vector<String> ret;
-			for (auto i = p::tokens.begin(); i != p::tokens.end(); i++)
-				ret.push_back(i.key());
+			FailureTracker tracker;
+			FailureTracker::Scope scope(&tracker);
+			ParseReport<Out> ret;
+			ret.value = Parse(tokens, index, g);
+			U32Itor at(tokens.text.begin() + index * TokenStream::Width, 1, index + 1, index * TokenStream::Width);
+			ret.farthest = tracker.Result(at);
+			ret.farthest.loc = tokens.At(ret.farthest.loc);
+			ret.errors = g.Context().errors;
 			return ret;
 		}
 	}
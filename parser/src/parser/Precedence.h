@@ -0,0 +1,276 @@
+#pragma once
+#include "parser/Symbols.h"
+namespace em
+{
+	namespace parser
+	{
+		enum class Assoc
+		{
+			Left,		// a - b - c is (a - b) - c.
+			Right		// a ^ b ^ c is a ^ (b ^ c).
+		};
+
+		// The operator table of precedence_. Operators with a higher binding
+		// power bind tighter. Operators given as strings are literals.
+		template <typename Out>
+		struct Operators
+		{
+			using Result = Out;
+			using Unary = Function<Out(Out const&)>;
+			using Binary = Function<Out(Out const&, Out const&)>;
+			struct Entry
+			{
+				Ptr<Expr<Void>> op;
+				uint32_t power;
+				Assoc assoc;
+				Unary unary;		// Set for prefix and postfix operators.
+				Binary binary;		// Set for infix operators.
+			};
+			Vector<Entry> prefix, infix, postfix;
+
+			Operators& Prefix(Node<Void> const& op, uint32_t power, Unary const& f)
+			{
+				prefix.push_back(Entry{ op.expr, power, Assoc::Right, f, nullptr });
+				return *this;
+			}
+			Operators& Infix(Node<Void> const& op, uint32_t power, Assoc assoc, Binary const& f)
+			{
+				infix.push_back(Entry{ op.expr, power, assoc, nullptr, f });
+				return *this;
+			}
+			Operators& Postfix(Node<Void> const& op, uint32_t power, Unary const& f)
+			{
+				postfix.push_back(Entry{ op.expr, power, Assoc::Left, f, nullptr });
+				return *this;
+			}
+			template <typename Char>
+			ValidCharReturn<Char, Operators&> Prefix(Char const* op, uint32_t power, Unary const& f)
+			{
+				return Prefix(_Token(op), power, f);
+			}
+			template <typename Char>
+			ValidCharReturn<Char, Operators&> Infix(Char const* op, uint32_t power, Assoc assoc, Binary const& f)
+			{
+				return Infix(_Token(op), power, assoc, f);
+			}
+			template <typename Char>
+			ValidCharReturn<Char, Operators&> Postfix(Char const* op, uint32_t power, Unary const& f)
+			{
+				return Postfix(_Token(op), power, f);
+			}
+		private:
+			template <typename Char>
+			static Node<Void> _Token(Char const* op)
+			{
+				return Node<Void>{ std::make_shared<TokenExpr<Char>>(op) };
+			}
+		};
+
+		// What the Analyzer needs of precedence_: Children() gives the operand,
+		// then this many prefix operators, then the others.
+		struct PrecedenceBase
+		{
+			virtual size_t Prefixes() const = 0;
+		};
+
+		// Precedence climbing over an operand and an operator table. The result
+		// is combined bottom-up as operators are read; only a tighter binding
+		// operator on the right recurses. A literal given as both an infix and a
+		// postfix operator is taken as postfix when no operand follows it, and a
+		// prefix operator without an operand after it as the start of an operand.
+		template <typename Out>
+		struct PrecedenceExpr : Expr<Out>, PrecedenceBase
+		{
+			using Result = Out;
+			using Entry = typename Operators<Out>::Entry;
+			Ptr<Expr<Out>> operand;
+			Vector<Entry> prefix;
+			// Infix and postfix operators, both follow an operand.
+			Vector<Entry> suffix;
+
+			PrecedenceExpr(Ptr<Expr<Out>> const& e, Operators<Out> const& ops)
+				: operand(e), prefix(ops.prefix), suffix(ops.infix)
+			{
+				suffix.insert(suffix.end(), ops.postfix.begin(), ops.postfix.end());
+				_Compile();
+			}
+
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return _Parse(input, end, s, 0);
+			}
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return _Match(input, end, s, 0);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Precedence; }
+			// The operand comes first, then the operators.
+			virtual void Children(Vector<ExprBase const*>& out) const
+			{
+				out.push_back(operand.get());
+				for (auto& e : prefix) out.push_back(e.op.get());
+				for (auto& e : suffix) out.push_back(e.op.get());
+			}
+			virtual size_t Prefixes() const { return prefix.size(); }
+			virtual String Describe() const { return operand->Describe(); }
+			virtual void Optimize(Optimizer& o)
+			{
+				o.Rewrite(operand);
+				for (auto& e : prefix) o.Rewrite(e.op);
+				for (auto& e : suffix) o.Rewrite(e.op);
+				_Compile();
+			}
+		private:
+			// Yield the index of the operator matched.
+			Ptr<Expr<uint32_t>> prefixOps, suffixOps;
+			enum : uint32_t { None = (uint32_t)-1 };
+			// By suffix index, the postfix operator with the same literal as an
+			// infix one, or None.
+			Vector<uint32_t> postfixOf;
+
+			Nullable<Out> _Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s, uint32_t min)
+			{
+				U32Itor save = input;
+				Nullable<Out> lhs;
+				Nullable<uint32_t> pre;
+				if (prefixOps) pre = prefixOps->Parse(input, end, s);
+				if (!pre.IsNull())
+				{
+					Entry const& e = prefix[pre.Get()];
+					Nullable<Out> arg = _Parse(input, end, s, e.power);
+					if (!arg.IsNull()) lhs = e.unary(arg.Get());
+				}
+				// Without an operand after it, a prefix operator may start one.
+				if (lhs.IsNull())
+				{
+					input = save;
+					ParseContext::Backtrack(save.Base());
+					lhs = operand->Parse(input, end, s);
+					if (lhs.IsNull()) return null;
+				}
+				while (suffixOps)
+				{
+					// Skipped text stays skipped, as after a repetition.
+					RunSkipper(s, input, end);
+					U32Itor at = input;
+					Nullable<uint32_t> op = suffixOps->Parse(input, end, s);
+					if (op.IsNull())
+					{
+						input = at;
+						ParseContext::Backtrack(at.Base());
+						break;
+					}
+					Entry const& e = suffix[op.Get()];
+					U32Itor after = input;
+					if (e.binary && e.power >= min)
+					{
+						Nullable<Out> rhs = _Parse(input, end, s,
+							Assoc::Left == e.assoc ? e.power + 1 : e.power);
+						if (!rhs.IsNull())
+						{
+							lhs = e.binary(lhs.Get(), rhs.Get());
+							continue;
+						}
+					}
+					uint32_t post = e.binary ? postfixOf[op.Get()] : op.Get();
+					if (None == post || suffix[post].power < min)
+					{
+						input = at;
+						ParseContext::Backtrack(at.Base());
+						break;
+					}
+					input = after;
+					ParseContext::Backtrack(after.Base());
+					lhs = suffix[post].unary(lhs.Get());
+				}
+				return lhs;
+			}
+			// The same climb without combining.
+			bool _Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s, uint32_t min)
+			{
+				U32Itor save = input;
+				Nullable<uint32_t> pre;
+				if (prefixOps) pre = prefixOps->Parse(input, end, s);
+				if (pre.IsNull() || !_Match(input, end, s, prefix[pre.Get()].power))
+				{
+					input = save;
+					if (!operand->Match(input, end, s)) return false;
+				}
+				while (suffixOps)
+				{
+					RunSkipper(s, input, end);
+					U32Itor at = input;
+					Nullable<uint32_t> op = suffixOps->Parse(input, end, s);
+					if (op.IsNull())
+					{
+						input = at;
+						break;
+					}
+					Entry const& e = suffix[op.Get()];
+					U32Itor after = input;
+					if (e.binary && e.power >= min && _Match(input, end, s,
+						Assoc::Left == e.assoc ? e.power + 1 : e.power))
+						continue;
+					uint32_t post = e.binary ? postfixOf[op.Get()] : op.Get();
+					if (None == post || suffix[post].power < min)
+					{
+						input = at;
+						break;
+					}
+					input = after;
+				}
+				return true;
+			}
+
+			// Literal operators are looked up in one trie where the longest one
+			// wins, the others are tried after it in order. A literal given again
+			// keeps its first entry; when that is infix and the later one postfix,
+			// 'same' gets the later one at the first.
+			static Ptr<Expr<uint32_t>> _Table(Vector<Entry> const& ops, Vector<uint32_t>* same)
+			{
+				if (ops.empty()) return nullptr;
+				auto trie = std::make_shared<SymbolsExpr<uint32_t>>(MatchMode::Longest);
+				Ptr<Expr<uint32_t>> ret;
+				Vector<String> keys(ops.size());
+				for (uint32_t i = 0; i < ops.size(); i++)
+				{
+					auto lit = std::dynamic_pointer_cast<LiteralExpr>(ops[i].op);
+					if (lit && lit->Utf8(keys[i]))
+					{
+						auto first = std::find(keys.begin(), keys.begin() + i, keys[i]);
+						if (first == keys.begin() + i) trie->Add(keys[i], i);
+						else if (same && ops[first - keys.begin()].binary && !ops[i].binary)
+							(*same)[first - keys.begin()] = i;
+						continue;
+					}
+					Ptr<Expr<uint32_t>> other = std::make_shared<Cast<Void, uint32_t>>(
+						ops[i].op, [i]() { return i; });
+					ret = ret ? MakeAlt(ret, other) : other;
+				}
+				if (trie->values.empty()) return ret;
+				return ret ? MakeAlt<uint32_t>(trie, ret) : trie;
+			}
+			void _Compile()
+			{
+				postfixOf.assign(suffix.size(), None);
+				prefixOps = _Table(prefix, nullptr);
+				suffixOps = _Table(suffix, &postfixOf);
+			}
+		};
+
+		template <typename Out>
+		inline Node<Out> precedence_(Node<Out> const& operand, Operators<Out> const& ops)
+		{
+			return Node<Out>{
+				std::make_shared<PrecedenceExpr<Out>>(operand.expr, ops)
+			};
+		}
+		template <typename Out>
+		inline Node<Out> precedence_(Rule<Out>& operand, Operators<Out> const& ops)
+		{
+			return Node<Out>{
+				std::make_shared<PrecedenceExpr<Out>>(operand.Alias(), ops)
+			};
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+#include "parser/GrammarBase.h"
+namespace em
+{
+	namespace parser
+	{
+		// Parses a stream of messages, each a match of the grammar, from input
+		// that comes in parts, without waiting for the rest. Feed() hands every
+		// message the input so far completes to the handler, with the context
+		// its ids are in, and drops its bytes. Spans in a value are valid only
+		// until the handler returns. A message whose parse read up to the end of
+		// the input so far is held back, as more input could change it, and
+		// parsed again from its start when more comes. Past Eager bytes it is
+		// only parsed again once its bytes have doubled, or on Finish(), so a
+		// message costs time linear in its size however it is cut, and a large
+		// one may be handed over some time after its last byte came. Locations
+		// count from the start of the stream. A grammar can serve any number of
+		// parsers.
+		template <typename Out>
+		struct PushParser
+		{
+			using Handler = Function<void(WarpVoid<Out>&, ParseContext&)>;
+			// Held back messages up to this size are parsed again on every Feed().
+			static const size_t Eager = 1024;
+
+			PushParser(GrammarBase<Out>& g, Handler const& f) : grammar(g), handler(f) {}
+			// False once the input can't be parsed, see Error().
+			bool Feed(char const* bytes, size_t size)
+			{
+				if (failed || finished) return !failed;
+				buffer.append(bytes, size);
+				return _Pump();
+			}
+			bool Feed(String const& bytes) { return Feed(bytes.data(), bytes.size()); }
+			// Parses what is left as whole messages, as no more input comes.
+			bool Finish()
+			{
+				if (failed || finished) return !failed;
+				finished = true;
+				return _Pump();
+			}
+			bool Failed() const { return failed; }
+			// Where the input could not be parsed and what was expected there.
+			Farthest const& Error() const { return error; }
+			// Bytes received but not parsed into messages yet.
+			size_t Pending() const { return buffer.size() - begin; }
+		private:
+			GrammarBase<Out>& grammar;
+			Handler handler;
+			ParseContext context;
+			String buffer;
+			size_t begin = 0;
+			uint32_t line = 1, col = 1, pos = 0;
+			bool failed = false, finished = false;
+			// The bytes of the held back message when it was last parsed, or 0.
+			size_t tried = 0;
+			Farthest error;
+			// The farthest failure in the messages parsed so far, as a whole
+			// parse would report it past the last message.
+			Nullable<Farthest> farthest;
+
+			// Where the input that can be read now ends: after the last whole
+			// character, and before a '\r' U32Itor would read together with a
+			// character that has not come yet.
+			size_t _Readable() const
+			{
+				size_t end = buffer.size();
+				if (finished) return end;
+				size_t at = end;
+				while (at > begin && end - at < 3 && 0x80 == (0xC0 & (uint8_t)buffer[at - 1])) at--;
+				if (at > begin)
+				{
+					uint8_t c = (uint8_t)buffer[at - 1];
+					size_t width = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+					if (end - (at - 1) < width) end = at - 1;
+				}
+				while (end > begin && '\r' == buffer[end - 1]) end--;
+				return end;
+			}
+			static bool _Before(Location const& a, Location const& b)
+			{
+				return a.line < b.line || (a.line == b.line && a.col < b.col);
+			}
+			bool _Fail(Farthest const& where)
+			{
+				failed = true;
+				error = where;
+				if (!farthest.IsNull() && _Before(where.loc, farthest.Get().loc)) error = farthest.Get();
+				return false;
+			}
+			bool _Pump()
+			{
+				while (begin < buffer.size())
+				{
+					size_t readable = _Readable();
+					if (readable == begin) break;
+					size_t size = readable - begin;
+					if (!finished && size >= Eager && size < 2 * tried) break;
+					auto from = buffer.begin() + begin, to = buffer.begin() + readable;
+					U32Itor input(from, line, col, pos), end(to);
+					FailureTracker tracker;
+					Nullable<WarpVoid<Out>> value;
+					try
+					{
+						FailureTracker::Scope scope(&tracker);
+						value = grammar.Parse(input, end, nullptr, context);
+					}
+					catch (ParseError const& e)
+					{
+						if (!finished && tracker.ReachedEnd())
+						{
+							tried = size;
+							break;
+						}
+						failed = true;
+						error = Farthest{ e.loc, { e.expected } };
+						return false;
+					}
+					if (!finished && tracker.ReachedEnd())
+					{
+						tried = size;
+						break;
+					}
+					tried = 0;
+					if (value.IsNull() || input.Base() == from) return _Fail(tracker.Result(input));
+					if (tracker.Failed())
+					{
+						Farthest here = tracker.Result(input);
+						if (farthest.IsNull() || !_Before(here.loc, farthest.Get().loc)) farthest = here;
+					}
+					handler(value.Get(), context);
+					line = input.Line();
+					col = input.Col();
+					pos = input.Pos();
+					begin = input.Base() - buffer.begin();
+					// Parsed bytes are dropped once they make up half the buffer.
+					if (begin * 2 >= buffer.size())
+					{
+						buffer.erase(0, begin);
+						begin = 0;
+					}
+				}
+				return true;
+			}
+		};
+		template <typename Out>
+		const size_t PushParser<Out>::Eager;
+	}
+}
\ No newline at end of file
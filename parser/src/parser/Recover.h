@@ -0,0 +1,99 @@
+#pragma once
+#include "parser/CharSet.h"
+namespace em
+{
+	namespace parser
+	{
+		enum class SyncMode
+		{
+			After,		// Moves past the sync character, like ';' or '\n'.
+			Before		// Stops at it, like a closing bracket the caller expects.
+		};
+
+		// On failure, or on a ParseError thrown after a cut, records the error
+		// to the ParseContext and skips from the farthest failure to the next
+		// sync character, then succeeds with a default result. Nesting is not
+		// tracked while skipping. Without progress, or without a context to
+		// record to, it fails as usual, so repetitions still end. An error is
+		// dropped again when an enclosing choice backtracks over its input.
+		template <typename Out>
+		struct RecoverExpr : Expr<Out>
+		{
+			using Result = Out;
+			Ptr<Expr<Out>> expr;
+			CharSet sync;
+			SyncMode mode;
+			RecoverExpr(Ptr<Expr<Out>> const& e, CharSet const& s, SyncMode m)
+				: expr(e), sync(s), mode(m) {}
+
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				Nullable<Out> res;
+				if (!_Run(input, end, [&]() {
+					res = expr->Parse(input, end, s);
+					return !res.IsNull();
+				})) return null;
+				if (res.IsNull()) return Out();
+				return res;
+			}
+			// Validate checks the input, so malformed input is not skipped here.
+			virtual bool Match(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				return expr->Match(input, end, s);
+			}
+			virtual ExprKind Kind() const { return ExprKind::Recover; }
+			virtual void Children(Vector<ExprBase const*>& out) const { out.push_back(expr.get()); }
+			virtual String Describe() const { return expr->Describe(); }
+			virtual void Optimize(Optimizer& o) { o.Rewrite(expr); }
+		private:
+			// Whether 'attempt' matched or the input could be skipped.
+			template <typename F>
+			bool _Run(U32Itor& input, U32Itor const& end, F const& attempt)
+			{
+				ParseContext* ctx = ParseContext::current;
+				if (!ctx) return attempt();
+				U32Itor save = input;
+				FailureTracker local;
+				FailureTracker* outer = FailureTracker::current;
+				bool matched = false;
+				Ptr<ParseError> thrown;
+				{
+					FailureTracker::Scope scope(&local);
+					try { matched = attempt(); }
+					catch (ParseError const& e) { thrown = std::make_shared<ParseError>(e); }
+				}
+				if (outer) outer->Merge(local);
+				if (matched) return true;
+
+				// Errors recovered from inside are given up with the input.
+				ParseContext::Backtrack(save.Base());
+				input = save;
+				if (local.Failed()) input.Advance(local.At());
+				input.Scan(end, (uint32_t)-1,
+					[this](CharT const& c) { return !sync.Has(c); });
+				if (input == end) FailureTracker::ReachEnd();
+				if (SyncMode::After == mode && input != end) ++input;
+				if (input.Base() == save.Base()) return false;
+				ctx->Recovered(save.Base(), thrown ? *thrown : local.Result(save).Error());
+				return true;
+			}
+		};
+
+		template <typename Out>
+		inline Node<Out> recover_(Node<Out> const& n, CharSet const& sync,
+			SyncMode mode = SyncMode::After)
+		{
+			return Node<Out>{
+				std::make_shared<RecoverExpr<Out>>(n.expr, sync, mode)
+			};
+		}
+		template <typename Out>
+		inline Node<WarpVoid<Out>> recover_(Rule<Out>& r, CharSet const& sync,
+			SyncMode mode = SyncMode::After)
+		{
+			return Node<WarpVoid<Out>>{
+				std::make_shared<RecoverExpr<WarpVoid<Out>>>(r.Alias(), sync, mode)
+			};
+		}
+	}
+}
\ No newline at end of file
@@ -10,8 +10,10 @@ namespace em
 			using Result = CondType<IsSame<Out, void>, Void, Out>;
 			Ptr<Expr<Result>> expr;
 			Ptr<Ref<Out>> ref = std::make_shared<Ref<Out>>(*this);
+			String name;
 
 			Rule() {};
+			Rule(char const* n) : name(n) {};
 			Rule(const Rule&) = delete;
 			//Rule(const Node<Result>& n) { expr = n.expr; }
 			Ptr<Ref<Out>> Alias() const { return ref; }
@@ -21,6 +23,16 @@ namespace em
 				expr = n.expr;
 				return *this;
 			}
+			Node<Result> operator>(CutMark const&) const
+			{
+				return Node<Result>{ Alias(), true };
+			}
+			template <typename T>
+			auto operator>=(T&& other) const
+				-> decltype(std::declval<Node<Result>>() > std::forward<T>(other))
+			{
+				return Node<Result>{ Alias(), true } > std::forward<T>(other);
+			}
 			template <typename COut>
 			Node<SequType<WarpVoid<Out>, COut>> operator>(Node<COut> const& n) const
 			{
@@ -0,0 +1,57 @@
+#include "parser/Symbols.h"
+namespace em
+{
+	namespace parser
+	{
+		namespace
+		{
+			// Appends the keys of a literal or of an ordered token set, in match order.
+			bool _CollectKeys(Ptr<Expr<Void>> const& e, Vector<String>& keys)
+			{
+				if (auto lit = std::dynamic_pointer_cast<LiteralExpr>(e))
+				{
+					String key;
+					if (!lit->Utf8(key)) return false;
+					keys.push_back(key);
+					return true;
+				}
+				if (auto sym = std::dynamic_pointer_cast<SymbolsExpr<Void>>(e))
+				{
+					if (MatchMode::Ordered != sym->mode || sym->boundary) return false;
+					Vector<String> ordered = sym->Keys();
+					keys.insert(keys.end(), ordered.begin(), ordered.end());
+					return true;
+				}
+				return false;
+			}
+		}
+
+		Ptr<Expr<Void>> MakeAlt(Ptr<Expr<Void>> const& l, Ptr<Expr<Void>> const& r)
+		{
+			auto a = std::dynamic_pointer_cast<SkipCharExpr>(l);
+			auto b = std::dynamic_pointer_cast<SkipCharExpr>(r);
+			if (a && b) return std::make_shared<SkipCharExpr>(a->skip | b->skip);
+			Vector<String> keys;
+			if (_CollectKeys(l, keys) && _CollectKeys(r, keys))
+			{
+				auto ret = std::make_shared<SymbolsExpr<Void>>(MatchMode::Ordered);
+				for (auto& k : keys) ret->Add(k, Void());
+				return ret;
+			}
+			return std::make_shared<Alt<Void>>(l, r);
+		}
+
+		Node<Void> keywords_(std::initializer_list<char const*> l, CharSet const& boundary)
+		{
+			Symbols<Void> sym;
+			for (auto& k : l) sym.Add(k, Void());
+			return symbols_(sym.Boundary(boundary));
+		}
+		Node<Void> keywords_(std::initializer_list<char32_t const*> l, CharSet const& boundary)
+		{
+			Symbols<Void> sym;
+			for (auto& k : l) sym.Add(k, Void());
+			return symbols_(sym.Boundary(boundary));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#pragma once
+#include "parser/GrammarBase.h"
+#include "parser/CharSet.h"
+namespace em
+{
+	namespace parser
+	{
+		enum class MatchMode
+		{
+			Longest,	// The longest key wins.
+			Ordered		// The first added key wins, same as '|' over literals.
+		};
+
+		template <typename Out>
+		struct Symbols
+		{
+			using Result = Out;
+			Vector<std::pair<String, Out>> keys;
+			MatchMode mode;
+			Ptr<CharSet> boundary;
+
+			Symbols(MatchMode m = MatchMode::Longest) : mode(m) {}
+			Symbols(std::initializer_list<std::pair<char const*, Out>> l,
+				MatchMode m = MatchMode::Longest) : mode(m)
+			{
+				for (auto& i : l) Add(i.first, i.second);
+			}
+			Symbols(std::initializer_list<std::pair<char32_t const*, Out>> l,
+				MatchMode m = MatchMode::Longest) : mode(m)
+			{
+				for (auto& i : l) Add(i.first, i.second);
+			}
+
+			// Keys given as char strings are UTF-8.
+			Symbols& Add(char const* key, Out const& value)
+			{
+				keys.push_back(std::make_pair(String(key), value));
+				return *this;
+			}
+			Symbols& Add(char32_t const* key, Out const& value)
+			{
+				keys.push_back(std::make_pair(ToUtf8(key), value));
+				return *this;
+			}
+			// A match is rejected when the next character is in the set.
+			Symbols& Boundary(CharSet const& set)
+			{
+				boundary = std::make_shared<CharSet>(set);
+				return *this;
+			}
+		};
+
+		// What the Analyzer and Dfa need of symbols_.
+		struct SymbolsBase
+		{
+			// The keys as UTF-8, in the order they were added.
+			virtual Vector<String> Keys() const = 0;
+			virtual MatchMode Mode() const = 0;
+			virtual bool HasBoundary() const = 0;
+		};
+
+		template <typename Out>
+		struct SymbolsExpr : Expr<Out>, SymbolsBase
+		{
+			using Result = Out;
+			TrieMap<uint32_t> trie;
+			Vector<Out> values;
+			Vector<uint32_t> sizes;
+			uint32_t maxSize = 0;
+			MatchMode mode;
+			Ptr<CharSet> boundary;
+
+			SymbolsExpr(MatchMode m, Ptr<CharSet> const& b = nullptr)
+				: mode(m), boundary(b) {}
+			SymbolsExpr(Symbols<Out> const& sym)
+				: mode(sym.mode), boundary(sym.boundary)
+			{
+				for (auto& i : sym.keys) Add(i.first, i.second);
+			}
+
+			// An existing key keeps its first value.
+			void Add(String const& key, Out const& value)
+			{
+				if (trie.find_ks(key.data(), key.size()) != trie.end()) return;
+				trie.insert_ks(key.data(), key.size(), (uint32_t)values.size());
+				values.push_back(value);
+				sizes.push_back((uint32_t)key.size());
+				maxSize = std::max(maxSize, (uint32_t)key.size());
+			}
+
+			virtual Vector<String> Keys() const
+			{
+				Vector<String> ret(values.size());
+				for (auto i = trie.begin(); i != trie.end(); ++i) ret[*i] = i.key();
+				return ret;
+			}
+			virtual MatchMode Mode() const { return mode; }
+			virtual bool HasBoundary() const { return !!boundary; }
+			virtual ExprKind Kind() const { return ExprKind::Symbols; }
+			virtual bool AcceptsEmpty() const
+			{
+				return std::find(sizes.begin(), sizes.end(), 0) != sizes.end();
+			}
+			virtual void FirstChars(CharSet& out) const
+			{
+				for (auto i = trie.begin(); i != trie.end(); ++i)
+				{
+					String key = i.key();
+					if (!key.empty()) out = out | CharSet{ CharRange(*U32Itor(key.begin())) };
+				}
+			}
+			virtual String Describe() const
+			{
+				String ret;
+				for (auto i = trie.begin(); i != trie.end(); ++i)
+					ret += (ret.empty() ? "\"" : " or \"") + i.key() + '"';
+				return ret;
+			}
+			virtual Nullable<Result> Parse(U32Itor& input, U32Itor const& end, Ptr<Expr<Void>> const& s)
+			{
+				RunSkipper(s, input, end);
+
+				// Look at the upcoming bytes directly, dropping '\r' as U32Itor does.
+				char stack[64];
+				String heap;
+				char* buf = stack;
+				if (maxSize > sizeof(stack))
+				{
+					heap.resize(maxSize);
+					buf = &heap[0];
+				}
+				uint32_t size = 0;
+				for (auto i = input.Base(), e = end.Base(); i != e && size < maxSize; ++i)
+					if ('\r' != *i) buf[size++] = *i;
+				// A longer key could still come.
+				if (size < maxSize) FailureTracker::ReachEnd();
+
+				uint32_t best = (uint32_t)-1;
+				U32Itor after = input;
+				while (true)
+				{
+					auto i = trie.longest_prefix_ks(buf, size);
+					if (i == trie.end()) break;
+					uint32_t idx = *i;
+					if (idx < best)
+					{
+						U32Itor next = input;
+						_Advance(next, sizes[idx]);
+						if (boundary && next == end) FailureTracker::ReachEnd();
+						if (!boundary || next == end || !boundary->Has(*next))
+						{
+							best = idx;
+							after = next;
+							if (MatchMode::Longest == mode) break;
+						}
+					}
+					if (0 == sizes[idx]) break;
+					size = sizes[idx] - 1;
+				}
+				if ((uint32_t)-1 == best)
+				{
+					FailureTracker::Fail(input, this);
+					return null;
+				}
+				input = after;
+				return values[best];
+			}
+		private:
+			// Moves over the characters of a matched key of 'size' bytes.
+			static void _Advance(U32Itor& it, uint32_t size)
+			{
+				auto to = it.Base();
+				while (size) if ('\r' != *to++) size--;
+				it.Advance(to);
+			}
+		};
+
+		template <typename Out>
+		inline Node<Out> symbols_(Symbols<Out> const& sym)
+		{
+			return Node<Out>{
+				std::make_shared<SymbolsExpr<Out>>(sym)
+			};
+		}
+		template <typename Out>
+		inline Node<Out> symbols_(std::initializer_list<std::pair<char const*, Out>> l,
+			MatchMode mode = MatchMode::Longest)
+		{
+			return symbols_(Symbols<Out>(l, mode));
+		}
+		template <typename Out>
+		inline Node<Out> symbols_(std::initializer_list<std::pair<char32_t const*, Out>> l,
+			MatchMode mode = MatchMode::Longest)
+		{
+			return symbols_(Symbols<Out>(l, mode));
+		}
+
+		Node<Void> keywords_(std::initializer_list<char const*> l,
+			CharSet const& boundary = XID_Continue);
+		Node<Void> keywords_(std::initializer_list<char32_t const*> l,
+			CharSet const& boundary = XID_Continue);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+# Generates src/parser/UnicodeTables.h from the Unicode Character Database.
+#
+#   GenUnicodeTables.py UCD_DIR [NAME=FILE:VALUE[,VALUE...] ...] > ../src/parser/UnicodeTables.h
+#
+# UCD_DIR holds the files of https://www.unicode.org/Public/UCD/latest/ucd/.
+# Each table is named NAME and holds the code points listed in FILE with one
+# of the VALUEs in its second field, or in the general category field for
+# UnicodeData.txt. The tables CharSet.cpp uses are always generated.
+import os
+import sys
+
+DEFAULT = [
+    ('XID_Start', 'DerivedCoreProperties.txt', ['XID_Start']),
+    ('XID_Continue', 'DerivedCoreProperties.txt', ['XID_Continue']),
+    ('Full_Width', 'EastAsianWidth.txt', ['W']),
+    ('Control_Char', 'UnicodeData.txt', ['Cc']),
+]
+
+
+def parse_property(path, values):
+    ranges = []
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            fields = [x.strip() for x in line.split(';')]
+            if len(fields) < 2 or fields[1] not in values:
+                continue
+            cps = fields[0].split('..')
+            ranges.append((int(cps[0], 16), int(cps[-1], 16)))
+    return ranges
+
+
+def parse_unicode_data(path, values):
+    # Large blocks are given as a pair of <..., First> and <..., Last> lines.
+    ranges = []
+    first = None
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            fields = line.split(';')
+            if len(fields) < 3:
+                continue
+            cp = int(fields[0], 16)
+            if fields[1].endswith(', First>'):
+                first = cp
+                continue
+            start = first if fields[1].endswith(', Last>') else cp
+            first = None
+            if fields[2] in values:
+                ranges.append((start, cp))
+    return ranges
+
+
+def merge(ranges):
+    ret = []
+    for a, b in sorted(ranges):
+        if ret and a <= ret[-1][1] + 1:
+            ret[-1] = (ret[-1][0], max(ret[-1][1], b))
+        else:
+            ret.append((a, b))
+    return ret
+
+
+def low_bitmap(ranges):
+    words = [0] * 32
+    for a, b in ranges:
+        for c in range(a, min(b, 0x7FF) + 1):
+            words[c >> 6] |= 1 << (c & 63)
+    return words
+
+
+def nibbles(words):
+    ret = [0] * 16
+    for c in range(0x80):
+        if words[c >> 6] >> (c & 63) & 1:
+            ret[c & 0xF] |= 1 << (c >> 4)
+    return ret
+
+
+def emit(tables):
+    out = [
+        '// Generated by parser/tools/GenUnicodeTables.py from the Unicode Character',
+        '// Database, do not edit.',
+        '#pragma once',
+        '#include "parser/CharSet.h"',
+        'namespace em',
+        '{',
+        '\tnamespace parser',
+        '\t{',
+        '\t\tnamespace unicode',
+        '\t\t{',
+    ]
+    for n, (name, ranges) in enumerate(tables):
+        ranges = merge(ranges)
+        if n:
+            out.append('')
+        out.append('\t\t\tconstexpr CharRange %s_Ranges[]{' % name)
+        items = ['{ 0x%04X, 0x%04X }' % r for r in ranges]
+        for i in range(0, len(items), 4):
+            out.append('\t\t\t\t' + ', '.join(items[i:i + 4]) + (',' if i + 4 < len(items) else ''))
+        out.append('\t\t\t};')
+        out.append('\t\t\tconstexpr CharTable %s{ %s_Ranges, %d, {' % (name, name, len(ranges)))
+        low = low_bitmap(ranges)
+        words = ['0x%016Xull' % w for w in low]
+        for i in range(0, 32, 4):
+            out.append('\t\t\t\t' + ', '.join(words[i:i + 4]) + (',' if i + 4 < 32 else ''))
+        out.append('\t\t\t}, {')
+        out.append('\t\t\t\t' + ', '.join('0x%02X' % b for b in nibbles(low)))
+        out.append('\t\t\t} };')
+    out += ['\t\t}', '\t}', '}']
+    return '\n'.join(out)
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.stderr.write(__doc__ if __doc__ else 'usage: GenUnicodeTables.py UCD_DIR [NAME=FILE:VALUE ...]\n')
+        return 1
+    specs = list(DEFAULT)
+    for arg in argv[2:]:
+        name, rest = arg.split('=', 1)
+        file, values = rest.split(':', 1)
+        specs.append((name, file, values.split(',')))
+    tables = []
+    for name, file, values in specs:
+        path = os.path.join(argv[1], file)
+        parse = parse_unicode_data if file == 'UnicodeData.txt' else parse_property
+        tables.append((name, parse(path, values)))
+    sys.stdout.write(emit(tables))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))